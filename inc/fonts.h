@@ -57,13 +57,55 @@
 #include "string.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+// FONT SETTINGS.
+///////////////////////////////////////////////////////////////////////////////
+
+// Set to 0 to leave out the 16x26 font, about 6 KB of flash. Large text can
+// be drawn instead with SSD1306_putsScaled from the smaller fonts.
+#define FONT_16X26 1
+
+///////////////////////////////////////////////////////////////////////////////
+
+
+// First and last characters of the ASCII table stored in the font arrays.
+#define FONT_FIRST_CHAR 32
+#define FONT_LAST_CHAR  126
+
+// Marks the code points of a sparse range without a glyph.
+#define FONT_NO_GLYPH   0xFF
+
+// Code point returned for malformed UTF-8 sequences and for code points
+// beyond U+FFFF.
+#define FONT_REPLACEMENT_CHAR 0xFFFD
+
+
+/**
+ * @brief Structure storing a range of code points of a font. The glyph of
+ *        code point c is stored at index glyph + (c - first) of the font data
+ *        or, in a sparse range, at index glyph + map[c - first].
+ */
+typedef struct {
+	uint16_t      first; /*!< First code point of the range. */
+	uint16_t      last;  /*!< Last code point of the range. */
+	uint16_t      glyph; /*!< Index of the first glyph of the range. */
+	const uint8_t *map;  /*!< Glyph offsets of a sparse range, FONT_NO_GLYPH
+	                          for missing code points, or NULL. */
+} FontRange_t;
+
+
 /**
  * @brief Structure storing font information.
  */
 typedef struct {
-	uint8_t fontWidth;    /*!< Font width in pixels. */
-	uint8_t fontHeight;   /*!< Font height in pixels. */
-	const uint16_t *data; /*!< Pointer to font data array. */
+	uint8_t fontWidth;         /*!< Font width in pixels. */
+	uint8_t fontHeight;        /*!< Font height in pixels. */
+	const uint16_t *data;      /*!< Pointer to font data array. */
+	const FontRange_t *ranges; /*!< Code point ranges, most used first, or
+	                                NULL for printable ASCII only. */
+	uint8_t rangeCount;        /*!< Number of code point ranges. */
+	uint16_t fallback;         /*!< Code point drawn in place of missing ones,
+	                                0 to skip them. */
 } FontDef_t;
 
 /** 
@@ -86,10 +128,12 @@ extern FontDef_t FontDef_7x10;
  */
 extern FontDef_t FontDef_11x18;
 
+#if FONT_16X26
 /**
  * @brief 16x26 pixels font size structure.
  */
 extern FontDef_t FontDef_16x26;
+#endif
 
 
 /**
@@ -103,6 +147,46 @@ extern FontDef_t FontDef_16x26;
  */
 void get_string_size(char *str, FontStringSize_t *sizeStruct, FontDef_t *font);
 
+
+/**
+ * @brief      Calculates the size in units of pixels of the box covered by
+ *             the given string when drawn rotated. At 90 and 270 degrees the
+ *             string runs along Y, so length and height are swapped.
+ *
+ * @param[in]  *str: string to be checked for length and height.
+ * @param[out] *sizeStruct: pointer to empty @ref FontStringSize_t structure
+ *             where the width (length) and height of the box are stored.
+ * @param[in]  *font: pointer to @ref FontDef_t font used for calculations.
+ * @param[in]  rotation: number of clockwise quarter turns, as in
+ *             SSD1306_rotation_t.
+ */
+void get_string_size_rotated(char *str, FontStringSize_t *sizeStruct,
+	FontDef_t *font, uint8_t rotation);
+
+
+/**
+ * @brief         Decodes the next UTF-8 encoded code point of a string.
+ *
+ * @param[in,out] **str: pointer to the string, moved past the decoded bytes.
+ *                It is not moved at the end of the string.
+ * @retval        The code point, FONT_REPLACEMENT_CHAR for malformed
+ *                sequences, or 0 at the end of the string.
+ */
+uint16_t get_code_point(const char **str);
+
+
+/**
+ * @brief     Looks up the glyph of a code point. Each range is checked with
+ *            two comparisons and at most one table read, so the cost does not
+ *            depend on the number of glyphs.
+ *
+ * @param[in] *font: pointer to @ref FontDef_t font used for the lookup.
+ * @param[in] cp: code point.
+ * @retval    Index of the glyph in the font data, the index of the fallback
+ *            glyph if the code point is missing, or -1 if neither exists.
+ */
+int16_t get_glyph_index(const FontDef_t *font, uint16_t cp);
+
 /* C++ detection */
 #ifdef __cplusplus
 	}
@@ -51,18 +51,101 @@
 // DRIVER SETTINGS.
 ///////////////////////////////////////////////////////////////////////////////
 
+// The SSD1306_ settings below can also be given on the compiler command line,
+// for example -DSSD1306_SHADOW_FLUSH=1.
+
 #define STM32_FLAVOUR STM32F1XX
 //#define STM32_FLAVOUR STM32F4XX
 
 #define SSD1306_I2C_ADDR    0x78
 //#define SSD1306_I2C_ADDR  0x7A
 
-#define SSD1306_WIDTH  128
-#define SSD1306_HEIGHT 64
+// Size of the LCD panel in pixels.
+#ifndef SSD1306_LCD_WIDTH
+#define SSD1306_LCD_WIDTH  128
+#endif
+#ifndef SSD1306_LCD_HEIGHT
+#define SSD1306_LCD_HEIGHT 64
+#endif
+
+// Set to 1 to use the LCD rotated by 90 or 270 degrees: SSD1306_WIDTH and
+// SSD1306_HEIGHT are swapped and the driver buffer is transposed 8x8 pixels
+// at a time while flushing. Not available in band rendering mode.
+#ifndef SSD1306_PORTRAIT
+#define SSD1306_PORTRAIT 0
+#endif
+
+// Set to 1 to render one page at a time into a single page buffer instead of
+// keeping the whole frame in RAM. Drawing is then done from a callback passed
+// to SSD1306_renderBands, which is run once per page.
+#ifndef SSD1306_BAND_RENDERING
+#define SSD1306_BAND_RENDERING 0
+#endif
+
+// Set to 1 to keep a copy of the LCD internal RAM (another 1 KB of RAM) and
+// let SSD1306_updateScreen send only the bytes that changed since the last
+// flush. Not available in band rendering mode.
+#ifndef SSD1306_SHADOW_FLUSH
+#define SSD1306_SHADOW_FLUSH 0
+#endif
+
+// Maximum number of data bytes sent by each SSD1306_updateScreenStep call.
+// Every call holds the i2c bus for two transactions: 5 command bytes and
+// SSD1306_FLUSH_CHUNK_SIZE + 2 data bytes, that is about
+// (SSD1306_FLUSH_CHUNK_SIZE + 7) * 9 bit times (0.9 ms at 400 kHz with 32).
+#ifndef SSD1306_FLUSH_CHUNK_SIZE
+#define SSD1306_FLUSH_CHUNK_SIZE 32
+#endif
+
+// RAM budget in bytes of the glyph render cache. Set to 0 to disable it,
+// otherwise it must be large enough for at least one cache entry (~90 bytes).
+#ifndef SSD1306_GLYPH_CACHE_SIZE
+#define SSD1306_GLYPH_CACHE_SIZE 0
+#endif
+
+// Set to 1 to make SSD1306_toggleInvert invert every byte of the driver
+// buffer instead of using the hardware inversion of the LCD.
+#ifndef SSD1306_SOFTWARE_INVERT
+#define SSD1306_SOFTWARE_INVERT 0
+#endif
+
+// Set to 1 to let tasks lock ranges of pages, so that tasks owning different
+// pages can draw at the same time and flushing waits only for the pages being
+// sent. It requires C11 atomics. Not available with the glyph cache.
+#ifndef SSD1306_REGION_LOCKS
+#define SSD1306_REGION_LOCKS 0
+#endif
+
+// Called while waiting for a locked page, for example taskYIELD() with
+// FreeRTOS. It spins by default.
+#ifndef SSD1306_LOCK_WAIT
+#define SSD1306_LOCK_WAIT()
+#endif
+
+// Set to 1 to let the application provide the driver buffer and the i2c
+// transfer buffer with SSD1306_initWithMemory instead of reserving them as
+// static arrays, so that they can be placed in a given RAM region. The
+// shadow copy and the portrait page buffer stay static.
+#ifndef SSD1306_EXTERNAL_MEMORY
+#define SSD1306_EXTERNAL_MEMORY 0
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
 
+#if SSD1306_BAND_RENDERING && SSD1306_SHADOW_FLUSH
+	#error Shadow flush is not available in band rendering mode
+#endif
+
+#if SSD1306_BAND_RENDERING && SSD1306_PORTRAIT
+	#error Portrait orientation is not available in band rendering mode
+#endif
+
+#if SSD1306_REGION_LOCKS && SSD1306_GLYPH_CACHE_SIZE > 0
+	#error The glyph cache is shared by all tasks and not protected by region locks
+#endif
+
+
 #if STM32_FLAVOUR == STM32F1XX
 	#include "stm32f1xx_hal.h"
 #elif STM32_FLAVOUR == STM32F4XX
@@ -78,6 +161,7 @@
 
 
 #define SSD1306_I2C_TIMEOUT	                         2000
+#define SSD1306_I2C_WARM_TIMEOUT                     10 // Warm start check.
 
 // Command defines.
 #define SSD1306_RIGHT_HORIZONTAL_SCROLL              0x26
@@ -91,9 +175,75 @@
 #define SSD1306_NORMALDISPLAY 						 0xA6
 #define SSD1306_INVERTDISPLAY 						 0xA7
 
+#define SSD1306_SET_CONTRAST                         0x81
+#define SSD1306_SET_FADE_BLINK                       0x23 // Fade out or blink.
+#define SSD1306_SET_ZOOM                             0xD6 // Zoom in.
+
+// Drawing area size in pixels.
+#if SSD1306_PORTRAIT
+	#define SSD1306_WIDTH							 SSD1306_LCD_HEIGHT
+	#define SSD1306_HEIGHT							 SSD1306_LCD_WIDTH
+#else
+	#define SSD1306_WIDTH							 SSD1306_LCD_WIDTH
+	#define SSD1306_HEIGHT							 SSD1306_LCD_HEIGHT
+#endif
+
+// Number of pages of the LCD internal RAM.
+#define SSD1306_MAX_PAGE_NUM						 (SSD1306_LCD_HEIGHT / 8)
+
 // Size in bytes of the temporary data storage to communicate with the i2c LCD.
-#define SSD1306_I2C_DATATMP_SIZE					 256
-#define SSD1306_MAX_PAGE_NUM						 8
+// In band rendering mode pages are sent straight from the band buffer, so
+// only room for command sequences is needed, the longest being the
+// initialization table.
+#if SSD1306_BAND_RENDERING
+	#define SSD1306_I2C_DATATMP_SIZE				 32
+#else
+	#define SSD1306_I2C_DATATMP_SIZE				 256
+#endif
+
+// Size in bytes of the driver buffer.
+#if SSD1306_BAND_RENDERING
+	#define SSD1306_BUFFER_SIZE						 SSD1306_WIDTH
+#else
+	#define SSD1306_BUFFER_SIZE						 (SSD1306_WIDTH * SSD1306_HEIGHT / 8)
+#endif
+
+// Memory needed by SSD1306_initWithMemory: the driver buffer (in band
+// rendering mode preceded by the i2c data control byte, so that pages are
+// sent without copying them), the i2c transfer buffer and their sum, used
+// when a single block holds both. Both memories must be aligned to
+// SSD1306_MEMORY_ALIGN bytes, so that the buffer kernels work on whole words
+// and transfers start on a word, so a single block holds the transfer buffer
+// at the first aligned offset after the driver buffer.
+#if SSD1306_BAND_RENDERING
+	#define SSD1306_BUFFER_MEMORY_SIZE				 (1 + SSD1306_BUFFER_SIZE)
+#else
+	#define SSD1306_BUFFER_MEMORY_SIZE				 SSD1306_BUFFER_SIZE
+#endif
+#define SSD1306_MEMORY_ALIGN						 4
+#define SSD1306_XFER_MEMORY_OFFSET					 \
+	((SSD1306_BUFFER_MEMORY_SIZE + SSD1306_MEMORY_ALIGN - 1) / \
+	 SSD1306_MEMORY_ALIGN * SSD1306_MEMORY_ALIGN)
+#define SSD1306_XFER_MEMORY_SIZE					 SSD1306_I2C_DATATMP_SIZE
+#define SSD1306_MEMORY_SIZE							 (SSD1306_XFER_MEMORY_OFFSET + \
+													  SSD1306_XFER_MEMORY_SIZE)
+
+// Maximum number of characters of a formatted number: 32 binary digits plus
+// sign and decimal point.
+#define SSD1306_NUM_MAX_CHARS						 34
+
+// Maximum number of digits of a seven-segment display.
+#define SSD1306_SEG_MAX_DIGITS						 10
+
+// Maximum number of lines of a text box.
+#define SSD1306_TEXT_MAX_LINES						 8
+
+// Maximum number of vertices of a filled polygon.
+#define SSD1306_POLYGON_MAX_VERTICES				 16
+
+// Size in bytes of a pre-rendered glyph in the cache: up to 16 columns over
+// at most 5 pages (a 32 pixel high glyph starting at the bottom of a page).
+#define SSD1306_GLYPH_CACHE_ENTRY_DATA				 (16 * 5)
 
 
 /**
@@ -103,7 +253,8 @@ typedef enum {
 	LCD_OK = 0x00,         /*!< LCD command success. */
 	I2C_ERROR = 0x01,      /*!< Error while trying to communicate with the LCD. */
 	INVALID_PARAMS = 0x02, /*!< Invalid arguments. */
-	NO_INIT = 0x03         /*!< Device has not been initialized before use. */
+	NO_INIT = 0x03,        /*!< Device has not been initialized before use. */
+	BUSY = 0x04            /*!< Resource temporarily unavailable, retry later. */
 } SSD1306_status_t;
 
 
@@ -116,6 +267,186 @@ typedef enum {
 } SSD1306_color_t;
 
 
+/**
+ * @brief SSD1306 text rendering mode enumeration.
+ */
+typedef enum {
+	SSD1306_TEXT_OPAQUE = 0x00,     /*!< Background pixels are painted with the
+	                                     inverse of the text color. */
+	SSD1306_TEXT_TRANSPARENT = 0x01 /*!< Background pixels are left untouched. */
+} SSD1306_textMode_t;
+
+
+/**
+ * @brief SSD1306 raster operation enumeration, used to compose images.
+ */
+typedef enum {
+	SSD1306_ROP_COPY = 0x00, /*!< Image pixels replace the buffer pixels. */
+	SSD1306_ROP_OR = 0x01,   /*!< Image white pixels are set. */
+	SSD1306_ROP_AND = 0x02,  /*!< Image black pixels are cleared. */
+	SSD1306_ROP_XOR = 0x03   /*!< Image white pixels are inverted. */
+} SSD1306_rop_t;
+
+
+/**
+ * @brief Page-format image, as generated by the tools/ssd1306_img host tool.
+ *        Pixels are stored as for @ref SSD1306_drawImage. Compressed data is
+ *        a sequence of runs, each starting with a control byte c: c < 0x80
+ *        is followed by c + 1 literal bytes, c >= 0x80 by one byte repeated
+ *        c - 0x7E times. Runs may cross pages.
+ */
+typedef struct {
+	uint16_t      width;      /*!< Width in pixels. */
+	uint16_t      height;     /*!< Height in pixels. */
+	uint8_t       compressed; /*!< 1 if data is RLE compressed, 0 if raw. */
+	const uint8_t *data;      /*!< Image data. */
+} SSD1306_image_t;
+
+
+/**
+ * @brief SSD1306 dithering enumeration, used to draw grayscale images.
+ */
+typedef enum {
+	SSD1306_DITHER_BAYER = 0x00,          /*!< 8x8 ordered dither. */
+	SSD1306_DITHER_FLOYD_STEINBERG = 0x01 /*!< Error diffusion. */
+} SSD1306_dither_t;
+
+
+/**
+ * @brief SSD1306 rotation enumeration, clockwise.
+ */
+typedef enum {
+	SSD1306_ROTATION_0 = 0x00,   /*!< Default orientation. */
+	SSD1306_ROTATION_90 = 0x01,  /*!< Portrait, needs SSD1306_PORTRAIT. */
+	SSD1306_ROTATION_180 = 0x02, /*!< Upside down. */
+	SSD1306_ROTATION_270 = 0x03  /*!< Portrait, needs SSD1306_PORTRAIT. */
+} SSD1306_rotation_t;
+
+
+/**
+ * @brief Point on the LCD. Coordinates may lie outside the visible area.
+ */
+typedef struct {
+	int16_t x; /*!< X location. */
+	int16_t y; /*!< Y location. */
+} SSD1306_point_t;
+
+
+/**
+ * @brief Numeric field redrawn in place. It remembers the characters shown
+ *        on the LCD so that only the ones that change are drawn again.
+ *        Fields must be set up with @ref SSD1306_initNumField.
+ */
+typedef struct {
+	uint16_t        x;        /*!< Top left X location of the field. */
+	uint16_t        y;        /*!< Top left Y location of the field. */
+	uint8_t         width;    /*!< Field width in characters. */
+	uint8_t         decimals; /*!< Number of fixed-point decimal digits. */
+	uint8_t         base;     /*!< Conversion base. */
+	char            pad;      /*!< Padding character, usually ' ' or '0'. */
+	FontDef_t       *font;    /*!< Font used to draw the field. */
+	SSD1306_color_t color;    /*!< Color used to draw the field. */
+	char            last[SSD1306_NUM_MAX_CHARS]; /*!< Characters on screen. */
+} SSD1306_numField_t;
+
+
+/**
+ * @brief SSD1306 horizontal text alignment enumeration.
+ */
+typedef enum {
+	SSD1306_ALIGN_LEFT = 0x00,   /*!< Lines start at the left side. */
+	SSD1306_ALIGN_CENTER = 0x01, /*!< Lines are centered. */
+	SSD1306_ALIGN_RIGHT = 0x02   /*!< Lines end at the right side. */
+} SSD1306_align_t;
+
+
+/**
+ * @brief Line of a text box, a run of bytes of the laid out string.
+ */
+typedef struct {
+	uint16_t start;  /*!< Offset of the first byte of the line. */
+	uint16_t bytes;  /*!< Length of the line in bytes. */
+	uint8_t  glyphs; /*!< Length of the line in glyphs. */
+} SSD1306_textLine_t;
+
+
+/**
+ * @brief Text box: a rectangle in which a string is broken into lines at
+ *        spaces. The line breaks are kept and computed again only when the
+ *        string changes. Boxes must be set up with @ref SSD1306_initTextBox.
+ */
+typedef struct {
+	int16_t            x;         /*!< Left X location of the box. */
+	int16_t            y;         /*!< Top Y location of the box. */
+	int16_t            w;         /*!< Width of the box. */
+	int16_t            h;         /*!< Height of the box. */
+	FontDef_t          *font;     /*!< Font used to draw the text. */
+	SSD1306_align_t    align;     /*!< Alignment of the lines. */
+	uint8_t            ellipsis;  /*!< Ends text that does not fit with "...". */
+	const char         *str;      /*!< String the lines were computed for. */
+	uint32_t           hash;      /*!< Hash of the string content. */
+	uint8_t            lineCount; /*!< Number of lines. */
+	uint8_t            truncated; /*!< The string does not fit the box. */
+	SSD1306_textLine_t lines[SSD1306_TEXT_MAX_LINES]; /*!< Line breaks. */
+} SSD1306_textBox_t;
+
+
+/**
+ * @brief Seven-segment display: a fixed-point number drawn with filled
+ *        segments of any size. Only segments that change state are drawn
+ *        again, and they are kept per digit until they are flushed.
+ *        Displays must be set up with @ref SSD1306_initSegDisplay.
+ */
+typedef struct {
+	int16_t         x;         /*!< Left X location of the display. */
+	int16_t         y;         /*!< Top Y location of the display. */
+	uint8_t         digitW;    /*!< Width of a digit in pixels. */
+	uint8_t         digitH;    /*!< Height of a digit in pixels. */
+	uint8_t         thickness; /*!< Thickness of the segments in pixels. */
+	uint8_t         digits;    /*!< Number of digits. */
+	uint8_t         decimals;  /*!< Number of fixed-point decimal digits. */
+	SSD1306_color_t color;     /*!< Color of the lit segments. */
+	uint8_t         drawn;     /*!< The display has been drawn once. */
+	uint8_t         last[SSD1306_SEG_MAX_DIGITS]; /*!< Segments on screen,
+	                                                   bit 0 to 6 for segments
+	                                                   a to g, bit 7 for the
+	                                                   decimal point. */
+	uint8_t         dirty[SSD1306_SEG_MAX_DIGITS]; /*!< Segments changed
+	                                                    since the last flush,
+	                                                    same bits as last. */
+} SSD1306_segDisplay_t;
+
+
+/**
+ * @brief Drawing callback used in band rendering mode. It receives the
+ *        context pointer given to @ref SSD1306_renderBands.
+ */
+typedef void (*SSD1306_drawCallback_t)(void *ctx);
+
+
+/**
+ * @brief Flush counters. Byte counts are bytes on the i2c wire, address
+ *        bytes included.
+ */
+typedef struct {
+	uint32_t flushes;       /*!< Number of flushes. */
+	uint32_t bytesSent;     /*!< Total bytes sent by the flushes. */
+	uint32_t bytesAvoided;  /*!< Total bytes saved compared to sending full
+	                             frames. */
+	uint32_t lastBytesSent; /*!< Bytes sent by the last flush. */
+} SSD1306_flushStats_t;
+
+
+/**
+ * @brief Glyph cache counters.
+ */
+typedef struct {
+	uint32_t accesses; /*!< Number of glyphs rendered through the cache. */
+	uint32_t hits;     /*!< Glyphs found already rendered. */
+	uint32_t misses;   /*!< Glyphs decoded from the font table. */
+} SSD1306_glyphCacheStats_t;
+
+
 /**
  * @brief Structure to store information about the LCD status.
  */
@@ -124,6 +455,9 @@ typedef struct {
 	uint16_t          currentX;    /*!< Current X position of the cursor. */
 	uint16_t          currentY;    /*!< Current Y position of the cursor. */
 	uint8_t           inverted;    /*!< Display color is inverted. */
+	uint8_t           hwInverted;  /*!< LCD hardware inversion is on. */
+	uint8_t           contrast;    /*!< Current LCD contrast. */
+	uint8_t           rotation;    /*!< Current @ref SSD1306_rotation_t. */
 	uint8_t           initialized; /*!< Display initialization flag. */
 } SSD1306_t;
 
@@ -143,6 +477,73 @@ typedef struct {
 SSD1306_status_t SSD1306_init(I2C_HandleTypeDef *i2c_ptr);
 
 
+/**
+ * @brief     Initializes the driver for an LCD that is likely still configured,
+ *            for example after a watchdog reset of the microcontroller. The
+ *            LCD is checked once with a short timeout and configured again
+ *            without turning it off and without clearing it, so the previous
+ *            content stays on screen until the first update. The rotation
+ *            and the inversion the LCD was left with must be given, so that
+ *            the content is not flipped or inverted. The contrast is not
+ *            sent again: the driver assumes the maximum until
+ *            @ref SSD1306_setContrast is called.
+ *
+ * @param[in] i2c_ptr: a pointer to the i2c peripheral used to communicate
+ *            with the LCD.
+ * @param[in] rotation: rotation set before the reset, as accepted by
+ *            @ref SSD1306_setRotation.
+ * @param[in] is_inverted: inversion set before the reset, as given to
+ *            @ref SSD1306_invertDisplay.
+ * @retval    I2C_ERROR if the LCD does not answer, in which case
+ *            @ref SSD1306_init should be used, otherwise a valid SSD1306 LCD
+ *            status as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_initWarm(I2C_HandleTypeDef *i2c_ptr,
+	SSD1306_rotation_t rotation, uint8_t is_inverted);
+
+
+#if SSD1306_EXTERNAL_MEMORY
+
+/**
+ * @brief     Sets the memory used as driver buffer and i2c transfer buffer.
+ *            The memory belongs to the driver until it is replaced, and must
+ *            not be touched by DMA or by the CPU while a flush is running.
+ *            After @ref SSD1306_sleep it can be lent to something else, as
+ *            long as the frame is drawn again before the next update.
+ * @note      @ref SSD1306_init and @ref SSD1306_initWarm fail with
+ *            INVALID_PARAMS until memory has been set.
+ *
+ * @param[in] *buffer: SSD1306_BUFFER_MEMORY_SIZE bytes for the driver
+ *            buffer, or SSD1306_MEMORY_SIZE bytes if xfer is NULL. It must
+ *            be aligned to SSD1306_MEMORY_ALIGN bytes.
+ * @param[in] *xfer: SSD1306_XFER_MEMORY_SIZE bytes from which i2c transfers
+ *            are made, for example in a DMA-capable region, or NULL to take
+ *            them from the buffer memory, at SSD1306_XFER_MEMORY_OFFSET. It
+ *            must be aligned to SSD1306_MEMORY_ALIGN bytes.
+ * @retval    INVALID_PARAMS if buffer is NULL or if buffer or xfer is
+ *            misaligned, otherwise a valid SSD1306 LCD status as described by
+ *            @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_setMemory(uint8_t *buffer, uint8_t *xfer);
+
+
+/**
+ * @brief     Sets the driver memory with @ref SSD1306_setMemory and then
+ *            initializes the LCD with @ref SSD1306_init.
+ *
+ * @param[in] i2c_ptr: a pointer to the i2c peripheral used to communicate
+ *            with the LCD.
+ * @param[in] *buffer: memory of the driver buffer.
+ * @param[in] *xfer: memory of the i2c transfer buffer, or NULL.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_initWithMemory(I2C_HandleTypeDef *i2c_ptr,
+	uint8_t *buffer, uint8_t *xfer);
+
+#endif
+
+
 /**
  * @brief  Clears the display.
  *
@@ -163,10 +564,32 @@ SSD1306_status_t SSD1306_clear(void);
 SSD1306_status_t SSD1306_invertDisplay(uint8_t is_inverted);
 
 
+/**
+ * @brief     Rotates the display by reprogramming the segment remap and the
+ *            COM scan direction of the LCD, so that drawing is not slowed
+ *            down. 0 and 180 degrees are available in the default
+ *            orientation, 90 and 270 degrees with SSD1306_PORTRAIT.
+ * @note      The LCD applies the segment remap only to the data written
+ *            afterwards, so @ref SSD1306_updateScreen() must be called after
+ *            that in order to see updates on the LCD screen.
+ *
+ * @param[in] rotation: new rotation. This parameter can be a value of
+ *            @ref SSD1306_rotation_t enumeration.
+ * @retval    INVALID_PARAMS if the rotation does not match the orientation
+ *            of the drawing area, otherwise a valid SSD1306 LCD status as
+ *            described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_setRotation(SSD1306_rotation_t rotation);
+
+
 /** 
  * @brief  Updates the LCD internal RAM with the content of the driver buffer.
+ *         When SSD1306_SHADOW_FLUSH is enabled, only the bytes that differ
+ *         from the LCD content are sent, grouped into runs so that the
+ *         addressing commands never cost more than the bytes they skip.
  * @note   This function must be called each time you do some changes
- *         to the LCD.
+ *         to the LCD. It is not available in band rendering mode, where
+ *         @ref SSD1306_renderBands must be used instead.
  *
  * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
  *         enumeration.
@@ -175,9 +598,72 @@ SSD1306_status_t SSD1306_updateScreen(void);
 
 
 /**
- * @brief  Toggles pixels inversion inside the internal RAM.
- * @note   @ref SSD1306_updateScreen() must be called after that in order to
- *         see updates on the LCD screen.
+ * @brief      Incremental version of @ref SSD1306_updateScreen. Each call
+ *             sends at most SSD1306_FLUSH_CHUNK_SIZE bytes of the driver
+ *             buffer and returns, keeping track of where to resume, so that
+ *             other devices on the same i2c bus can be served between calls.
+ *             The first call after a completed flush starts a new one.
+ * @note       Changes made to the driver buffer during a flush are sent only
+ *             if they are in the part not yet sent (or, with
+ *             SSD1306_SHADOW_FLUSH, by the next flush). A call to
+ *             @ref SSD1306_updateScreen aborts the incremental flush.
+ *
+ * @param[out] *done: set to 1 when the whole frame has been sent, 0 if more
+ *             calls are needed.
+ * @retval     A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *             enumeration.
+ */
+SSD1306_status_t SSD1306_updateScreenStep(uint8_t *done);
+
+
+/**
+ * @brief     Updates the LCD internal RAM with a rectangular area of the
+ *            driver buffer. Since the LCD RAM is organized in pages of 8
+ *            rows, the whole pages touched by the area are sent, but only
+ *            for the columns of the area. Areas spanning several pages are
+ *            sent as a strip, see @ref SSD1306_updateColumns.
+ * @note      It is not available in band rendering mode.
+ *
+ * @param[in] x: top left X location. Valid input is 0 to SSD1306_WIDTH-1.
+ * @param[in] y: top left Y location. Valid input is 0 to SSD1306_HEIGHT-1.
+ * @param[in] w: area width in units of pixels.
+ * @param[in] h: area height in units of pixels.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_updateArea(uint16_t x, uint16_t y, uint16_t w,
+	uint16_t h);
+
+
+/**
+ * @brief     Updates the LCD internal RAM with a strip of columns of the
+ *            driver buffer. The LCD is temporarily switched to vertical
+ *            addressing, so that the whole strip is sent in column-major
+ *            order without addressing each page.
+ * @note      It is not available in band rendering mode. The strip is given
+ *            in LCD RAM columns and pages, which are rows of the drawing area
+ *            with SSD1306_PORTRAIT.
+ *
+ * @param[in] x: left X location. Valid input is 0 to SSD1306_LCD_WIDTH-1.
+ * @param[in] w: strip width in units of pixels.
+ * @param[in] start_page: location of the upper page. Valid inputs are between
+ *            0 and SSD1306_MAX_PAGE_NUM-1.
+ * @param[in] end_page: location of the lower page. Valid inputs are between
+ *            start_page and SSD1306_MAX_PAGE_NUM-1.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_updateColumns(uint16_t x, uint16_t w,
+	uint8_t start_page, uint8_t end_page);
+
+
+/**
+ * @brief  Toggles the inversion of the whole screen. By default the LCD
+ *         hardware inversion is used, so no data has to be sent. With
+ *         SSD1306_SOFTWARE_INVERT the driver buffer is inverted instead,
+ *         @ref SSD1306_updateScreen() must be called after that in order to
+ *         see updates on the LCD screen and it is not available in band
+ *         rendering mode.
  *
  * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
  *         enumeration.
@@ -254,6 +740,79 @@ SSD1306_status_t SSD1306_scrollDiagLeft(uint8_t start_page, uint8_t end_page);
 SSD1306_status_t SSD1306_stopScroll(void);
 
 
+/**
+ * @brief     Starts fading out the screen. The LCD lowers the contrast by
+ *            itself until the screen is off and keeps it off.
+ *
+ * @param[in] interval: time between contrast steps, in units of 8 frames
+ *            minus one. Valid inputs are between 0 (8 frames) and 15
+ *            (128 frames).
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_fadeOut(uint8_t interval);
+
+
+/**
+ * @brief     Starts blinking the screen. The LCD fades out and back in by
+ *            itself, continuously.
+ *
+ * @param[in] interval: time between contrast steps, in units of 8 frames
+ *            minus one. Valid inputs are between 0 (8 frames) and 15
+ *            (128 frames).
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_blink(uint8_t interval);
+
+
+/**
+ * @brief  Stops fading out or blinking, restoring the contrast.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_stopFade(void);
+
+
+/**
+ * @brief     Enables or disables the hardware zoom, which doubles every row
+ *            of the upper or lower half of the screen, depending on the
+ *            display start line.
+ *
+ * @param[in] enable: when equal to 0 the zoom is disabled, otherwise it is
+ *            enabled.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_zoom(uint8_t enable);
+
+
+/**
+ * @brief     Sets the LCD contrast.
+ *
+ * @param[in] contrast: contrast level. Valid inputs are between 0 and 255.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_setContrast(uint8_t contrast);
+
+
+/**
+ * @brief      Moves the LCD contrast one step towards the given level. It is
+ *             meant to be called periodically, for example from a timer, to
+ *             ramp the contrast smoothly with a single command per call.
+ *
+ * @param[in]  target: contrast level to be reached.
+ * @param[in]  step: maximum contrast change per call. It must be at least 1.
+ * @param[out] *done: set to 1 when the target level has been reached.
+ * @retval     A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *             enumeration.
+ */
+SSD1306_status_t SSD1306_contrastStep(uint8_t target, uint8_t step,
+	uint8_t *done);
+
+
 /** 
  * @brief     Fills the entire LCD with desired color.
  * @note      @ref SSD1306_updateScreen() must be called after that in order to
@@ -301,6 +860,123 @@ SSD1306_status_t SSD1306_drawBitmap(int16_t x, int16_t y,
 	const unsigned char* bitmap, int16_t w, int16_t h, SSD1306_color_t color);
 
 
+/**
+ * @brief     Draws an image stored in the same page format as the buffer:
+ *            each byte holds 8 vertical pixels, the LSB on top, and the
+ *            image is stored page by page, w bytes per page. The image is
+ *            composed with the buffer 32 bits at a time at any Y location.
+ *
+ * @param[in] x: X location of the left side of the image.
+ * @param[in] y: Y location of the top side of the image.
+ * @param[in] *image: pointer to the image, (h + 7) / 8 * w bytes long.
+ * @param[in] w: width of the image.
+ * @param[in] h: height of the image.
+ * @param[in] rop: how image pixels are composed with the buffer. This
+ *            parameter can be a value of @ref SSD1306_rop_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawImage(int16_t x, int16_t y, const uint8_t *image,
+	int16_t w, int16_t h, SSD1306_rop_t rop);
+
+
+/**
+ * @brief     Inverts the pixels of a rectangle in the buffer, for example to
+ *            highlight a menu entry.
+ *
+ * @param[in] x: X location of the left side of the rectangle.
+ * @param[in] y: Y location of the top side of the rectangle.
+ * @param[in] w: width of the rectangle.
+ * @param[in] h: height of the rectangle.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_invertRect(int16_t x, int16_t y, int16_t w,
+	int16_t h);
+
+
+/**
+ * @brief     Draws a page-format image, raw or RLE compressed. The data is
+ *            decoded while drawing, one image page at a time, so no buffer
+ *            for the whole decoded image is needed.
+ *
+ * @param[in] x: X location of the left side of the image.
+ * @param[in] y: Y location of the top side of the image.
+ * @param[in] *image: pointer to the @ref SSD1306_image_t image.
+ * @param[in] rop: how image pixels are composed with the buffer. This
+ *            parameter can be a value of @ref SSD1306_rop_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawPackedImage(int16_t x, int16_t y,
+	const SSD1306_image_t *image, SSD1306_rop_t rop);
+
+
+/**
+ * @brief     Sends a full screen image straight to the LCD, decoding it into
+ *            the transmit buffer, for example for a splash screen before the
+ *            driver buffer is used or in band rendering mode. The driver
+ *            buffer is left untouched, so the next flush may overwrite the
+ *            image.
+ *
+ * @param[in] *image: pointer to the @ref SSD1306_image_t image, in LCD RAM
+ *            layout: SSD1306_LCD_WIDTH x SSD1306_LCD_HEIGHT pixels.
+ * @retval    INVALID_PARAMS if the image size does not match the LCD,
+ *            otherwise a valid SSD1306 LCD status as described by
+ *            @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_sendImage(const SSD1306_image_t *image);
+
+
+/**
+ * @brief     Draws an 8-bit grayscale image, dithered into black and white
+ *            pixels. The image is converted one page at a time straight into
+ *            page bytes, so no 1bpp copy of the image is needed. Bright
+ *            pixels are drawn white. With error diffusion, the error is only
+ *            spread within the visible part of the image.
+ *
+ * @param[in] x: X location of the left side of the image.
+ * @param[in] y: Y location of the top side of the image.
+ * @param[in] *gray: pointer to the image, w * h bytes row by row, 0 being
+ *            black and 255 white.
+ * @param[in] w: width of the image.
+ * @param[in] h: height of the image.
+ * @param[in] dither: dithering method. This parameter can be a value of
+ *            @ref SSD1306_dither_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawGray(int16_t x, int16_t y, const uint8_t *gray,
+	int16_t w, int16_t h, SSD1306_dither_t dither);
+
+
+/**
+ * @brief     Restricts drawing to a rectangle: the drawing functions leave
+ *            pixels outside of it untouched. @ref SSD1306_fill and
+ *            @ref SSD1306_toggleInvert always act on the whole buffer.
+ *
+ * @param[in] x: top left X location.
+ * @param[in] y: top left Y location.
+ * @param[in] w: rectangle width in units of pixels.
+ * @param[in] h: rectangle height in units of pixels.
+ * @retval    INVALID_PARAMS if the rectangle does not overlap the visible
+ *            area, in which case clipping is reset. Otherwise a valid SSD1306
+ *            LCD status as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_setClipRect(int16_t x, int16_t y, int16_t w,
+	int16_t h);
+
+
+/**
+ * @brief  Removes the clipping rectangle, so that the whole visible area can
+ *         be drawn again.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_resetClipRect(void);
+
+
 /**
  * @brief     Sets cursor pointer to desired location.
  *
@@ -319,7 +995,8 @@ SSD1306_status_t SSD1306_gotoXY(uint16_t x, uint16_t y);
  * @note      @ref SSD1306_updateScreen() must be called after that in order
  *            to see updates on the LCD screen.
  *
- * @param[in] ch: the character to be written.
+ * @param[in] ch: the character to be written, taken as a Latin-1 code
+ *            point.
  * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
  * @param[in] color: color used for drawing. This parameter can be a value of
  *            @ref SSD1306_color_t enumeration.
@@ -334,7 +1011,8 @@ SSD1306_status_t SSD1306_putc(char ch, FontDef_t *font, SSD1306_color_t color);
  * @note      @ref SSD1306_updateScreen() must be called after that in order to
  * 			  see updates on the LCD screen.
  *
- * @param[in] *str: string to be written.
+ * @param[in] *str: UTF-8 encoded string to be written. Code points missing
+ *            from the font are drawn with its fallback glyph.
  * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
  * @param[in] color: color used for drawing. This parameter can be a value of
  *            @ref SSD1306_color_t enumeration.
@@ -345,11 +1023,166 @@ SSD1306_status_t SSD1306_puts(char* str, FontDef_t *font, SSD1306_color_t color)
 
 
 /**
- * @brief     Converts the given signed number into a string of the specified
- * 			  base and prints it on the LCD. @ref SSD1306_updateScreen() must
- * 			  be called after that in order to see updates on the LCD screen.
+ * @brief     Puts string into internal RAM using the given rendering mode.
+ *            The visible part of the string is computed once, then each glyph
+ *            is written into the buffer one page column at a time.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ * 			  see updates on the LCD screen.
  *
- * @param[in] num: the signed number to print.
+ * @param[in] *str: UTF-8 encoded string to be written. Code points missing
+ *            from the font are drawn with its fallback glyph.
+ * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in] color: color used for drawing. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @param[in] mode: background handling. This parameter can be a value of
+ *            @ref SSD1306_textMode_t enumeration.
+ * @retval    INVALID_PARAMS if the string has been truncated because it does
+ *            not fit the visible area, otherwise a valid SSD1306 LCD status
+ *            as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_putsMode(char* str, FontDef_t *font,
+	SSD1306_color_t color, SSD1306_textMode_t mode);
+
+
+/**
+ * @brief     Puts string into internal RAM, each glyph enlarged by an integer
+ *            factor. Glyph columns are expanded straight into page bytes
+ *            through bit repetition tables, so that big digits can be drawn
+ *            from a small font instead of storing a large one.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ * 			  see updates on the LCD screen.
+ *
+ * @param[in] *str: UTF-8 encoded string to be written.
+ * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in] scale: enlargement factor, from 1 to 4.
+ * @param[in] color: color used for drawing. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @param[in] mode: background handling. This parameter can be a value of
+ *            @ref SSD1306_textMode_t enumeration.
+ * @retval    INVALID_PARAMS if the string has been truncated because it does
+ *            not fit the visible area, otherwise a valid SSD1306 LCD status
+ *            as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_putsScaled(char *str, FontDef_t *font, uint8_t scale,
+	SSD1306_color_t color, SSD1306_textMode_t mode);
+
+
+/**
+ * @brief     Puts a character rotated clockwise into internal RAM, with the
+ *            top left corner of the rotated glyph at the current location.
+ *            The pointer is moved by the font width in the reading
+ *            direction: towards +X at 0 degrees, +Y at 90, -X at 180 and -Y
+ *            at 270, so that consecutive characters read in the same order
+ *            as with @ref SSD1306_putsRotated.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ * 			  see updates on the LCD screen.
+ *
+ * @param[in] ch: character to be written, taken as a Latin-1 code point.
+ * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in] rotation: text rotation. This parameter can be a value of
+ *            @ref SSD1306_rotation_t enumeration.
+ * @param[in] color: color used for drawing. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_putcRotated(char ch, FontDef_t *font,
+	SSD1306_rotation_t rotation, SSD1306_color_t color);
+
+
+/**
+ * @brief     Puts string rotated clockwise into internal RAM, for example as
+ *            a side label. The top left corner of the string box, whose size
+ *            is given by @ref get_string_size_rotated, is at the current
+ *            location and the pointer is moved past it. At 90 and 270 degrees
+ *            font rows are written straight as page columns.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ * 			  see updates on the LCD screen.
+ *
+ * @param[in] *str: UTF-8 encoded string to be written.
+ * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in] rotation: text rotation. This parameter can be a value of
+ *            @ref SSD1306_rotation_t enumeration.
+ * @param[in] color: color used for drawing. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @param[in] mode: background handling. This parameter can be a value of
+ *            @ref SSD1306_textMode_t enumeration.
+ * @retval    INVALID_PARAMS if the string has been truncated because it does
+ *            not fit the visible area, otherwise a valid SSD1306 LCD status
+ *            as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_putsRotated(char *str, FontDef_t *font,
+	SSD1306_rotation_t rotation, SSD1306_color_t color,
+	SSD1306_textMode_t mode);
+
+
+#if SSD1306_SHADOW_FLUSH
+
+/**
+ * @brief  Forces the next @ref SSD1306_updateScreen to send the whole frame.
+ *         It must be called if the LCD internal RAM has been changed behind
+ *         the driver, for example by a reset of the LCD. Hardware scrolling
+ *         does it automatically.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_invalidateShadow(void);
+
+
+/**
+ * @brief      Reads the flush counters.
+ *
+ * @param[out] *stats: pointer to the @ref SSD1306_flushStats_t structure to
+ *             be filled.
+ * @retval     A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *             enumeration.
+ */
+SSD1306_status_t SSD1306_getFlushStats(SSD1306_flushStats_t *stats);
+
+
+/**
+ * @brief  Resets the flush counters.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_resetFlushStats(void);
+
+#endif
+
+
+#if SSD1306_GLYPH_CACHE_SIZE > 0
+
+/**
+ * @brief      Reads the glyph cache counters.
+ *
+ * @param[out] *stats: pointer to the @ref SSD1306_glyphCacheStats_t structure
+ *             to be filled.
+ * @retval     A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *             enumeration.
+ */
+SSD1306_status_t SSD1306_getGlyphCacheStats(SSD1306_glyphCacheStats_t *stats);
+
+
+/**
+ * @brief  Empties the glyph cache and resets its counters. It must be called
+ *         if the data of a cached font is changed at runtime.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_resetGlyphCache(void);
+
+#endif
+
+
+/**
+ * @brief     Converts the given signed number into a string of the specified
+ * 			  base and prints it on the LCD. @ref SSD1306_updateScreen() must
+ * 			  be called after that in order to see updates on the LCD screen.
+ *
+ * @param[in] num: the signed number to print.
  * @param[in] base: the conversion base.
  * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
  * @param[in] color: color used for drawing. This parameter can be a value of
@@ -361,6 +1194,218 @@ SSD1306_status_t SSD1306_putInt(int32_t num, uint8_t base, FontDef_t *font,
 	SSD1306_color_t color);
 
 
+/**
+ * @brief     Prints a signed number right-aligned in a field of the given
+ *            width. @ref SSD1306_updateScreen() must be called after that in
+ *            order to see updates on the LCD screen.
+ *
+ * @param[in] num: the signed number to print.
+ * @param[in] base: the conversion base.
+ * @param[in] width: field width in characters, up to SSD1306_NUM_MAX_CHARS.
+ * @param[in] pad: character filling the field on the left. With '0' the
+ *            sign is printed before the padding zeros.
+ * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in] color: color used for drawing. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    INVALID_PARAMS if the number does not fit the field, otherwise
+ *            a valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_putIntPadded(int32_t num, uint8_t base,
+	uint8_t width, char pad, FontDef_t *font, SSD1306_color_t color);
+
+
+/**
+ * @brief     Prints a fixed-point number right-aligned in a field of the
+ *            given width. For example num = -1234 and decimals = 2 prints
+ *            "-12.34". @ref SSD1306_updateScreen() must be called after that
+ *            in order to see updates on the LCD screen.
+ *
+ * @param[in] num: the number scaled by 10^decimals.
+ * @param[in] decimals: number of digits after the decimal point.
+ * @param[in] width: field width in characters, up to SSD1306_NUM_MAX_CHARS.
+ * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in] color: color used for drawing. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    INVALID_PARAMS if the number does not fit the field, otherwise
+ *            a valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_putFixed(int32_t num, uint8_t decimals,
+	uint8_t width, FontDef_t *font, SSD1306_color_t color);
+
+
+/**
+ * @brief     Prints an unsigned number as zero-padded hexadecimal digits.
+ *            @ref SSD1306_updateScreen() must be called after that in order
+ *            to see updates on the LCD screen.
+ *
+ * @param[in] num: the number to print.
+ * @param[in] digits: number of digits printed, between 1 and 8.
+ * @param[in] *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in] color: color used for drawing. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_putHex(uint32_t num, uint8_t digits, FontDef_t *font,
+	SSD1306_color_t color);
+
+
+/**
+ * @brief      Sets up a numeric field. Nothing is drawn until the first call
+ *             to @ref SSD1306_updateNumField.
+ *
+ * @param[out] *field: pointer to the @ref SSD1306_numField_t to set up.
+ * @param[in]  x: top left X location of the field.
+ * @param[in]  y: top left Y location of the field.
+ * @param[in]  width: field width in characters, up to SSD1306_NUM_MAX_CHARS.
+ * @param[in]  decimals: number of fixed-point decimal digits, 0 for integers.
+ * @param[in]  base: the conversion base.
+ * @param[in]  pad: character filling the field on the left.
+ * @param[in]  *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in]  color: color used for drawing. This parameter can be a value of
+ *             @ref SSD1306_color_t enumeration.
+ * @retval     INVALID_PARAMS if the field does not fit the visible area,
+ *             otherwise a valid SSD1306 LCD status as described by
+ *             @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_initNumField(SSD1306_numField_t *field, uint16_t x,
+	uint16_t y, uint8_t width, uint8_t decimals, uint8_t base, char pad,
+	FontDef_t *font, SSD1306_color_t color);
+
+
+/**
+ * @brief     Shows a new value in a numeric field, redrawing only the
+ *            characters that differ from the ones already on screen.
+ *            @ref SSD1306_updateScreen() must be called after that in order
+ *            to see updates on the LCD screen.
+ *
+ * @param[in] *field: pointer to a field set up by @ref SSD1306_initNumField.
+ * @param[in] num: the value to show, scaled by 10^decimals.
+ * @retval    INVALID_PARAMS if the number does not fit the field, otherwise
+ *            a valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_updateNumField(SSD1306_numField_t *field,
+	int32_t num);
+
+
+/**
+ * @brief      Sets up a text box. Nothing is drawn until the first call to
+ *             @ref SSD1306_drawTextBox.
+ *
+ * @param[out] *box: pointer to the @ref SSD1306_textBox_t to set up.
+ * @param[in]  x: left X location of the box.
+ * @param[in]  y: top Y location of the box.
+ * @param[in]  w: width of the box, at least one glyph wide.
+ * @param[in]  h: height of the box, at least one glyph high. At most
+ *             SSD1306_TEXT_MAX_LINES lines are used.
+ * @param[in]  *font: pointer to @ref FontDef_t structure with the used font.
+ * @param[in]  align: alignment of the lines. This parameter can be a value of
+ *             @ref SSD1306_align_t enumeration.
+ * @param[in]  ellipsis: if not 0, the last line of text that does not fit
+ *             the box ends with "...".
+ * @retval     INVALID_PARAMS if the box does not fit the visible area,
+ *             otherwise a valid SSD1306 LCD status as described by
+ *             @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_initTextBox(SSD1306_textBox_t *box, int16_t x,
+	int16_t y, int16_t w, int16_t h, FontDef_t *font, SSD1306_align_t align,
+	uint8_t ellipsis);
+
+
+/**
+ * @brief     Breaks a string into the lines of a text box. Lines are broken
+ *            at spaces, or inside words longer than a line, and at '\n'.
+ *            Nothing is done if the string is the same as in the previous
+ *            call, both in address and in content.
+ *
+ * @param[in] *box: pointer to a box set up by @ref SSD1306_initTextBox.
+ * @param[in] *str: UTF-8 encoded string to lay out.
+ * @retval    INVALID_PARAMS if the string does not fit the box, otherwise a
+ *            valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_layoutText(SSD1306_textBox_t *box, const char *str);
+
+
+/**
+ * @brief     Draws a string in a text box, laying it out first with
+ *            @ref SSD1306_layoutText. In opaque mode the whole box is
+ *            cleared, so that nothing is left of a previous longer string.
+ *            @ref SSD1306_updateScreen() must be called after that in order
+ *            to see updates on the LCD screen.
+ *
+ * @param[in] *box: pointer to a box set up by @ref SSD1306_initTextBox.
+ * @param[in] *str: UTF-8 encoded string to draw.
+ * @param[in] color: color used for drawing. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @param[in] mode: background handling. This parameter can be a value of
+ *            @ref SSD1306_textMode_t enumeration.
+ * @retval    INVALID_PARAMS if the string does not fit the box, otherwise a
+ *            valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawTextBox(SSD1306_textBox_t *box, const char *str,
+	SSD1306_color_t color, SSD1306_textMode_t mode);
+
+
+/**
+ * @brief      Sets up a seven-segment display. Digits are thickness + 2
+ *             pixels apart, which leaves room for the decimal point. Nothing
+ *             is drawn until the first call to @ref SSD1306_updateSegDisplay.
+ *
+ * @param[out] *disp: pointer to the @ref SSD1306_segDisplay_t to set up.
+ * @param[in]  x: left X location of the display.
+ * @param[in]  y: top Y location of the display.
+ * @param[in]  digits: number of digits, up to SSD1306_SEG_MAX_DIGITS,
+ *             including the one used by the minus sign.
+ * @param[in]  decimals: number of fixed-point decimal digits, 0 for integers.
+ * @param[in]  digit_w: width of a digit, at least 2 * thickness + 1.
+ * @param[in]  digit_h: height of a digit, at least 3 * thickness + 2.
+ * @param[in]  thickness: thickness of the segments.
+ * @param[in]  color: color of the lit segments. This parameter can be a
+ *             value of @ref SSD1306_color_t enumeration.
+ * @retval     INVALID_PARAMS if the display does not fit the visible area,
+ *             otherwise a valid SSD1306 LCD status as described by
+ *             @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_initSegDisplay(SSD1306_segDisplay_t *disp, int16_t x,
+	int16_t y, uint8_t digits, uint8_t decimals, uint8_t digit_w,
+	uint8_t digit_h, uint8_t thickness, SSD1306_color_t color);
+
+
+/**
+ * @brief     Shows a new value on a seven-segment display. Only the segments
+ *            that change state are filled, lit or dark, and they are marked
+ *            to be flushed.
+ *
+ * @param[in] *disp: pointer to a display set up by
+ *            @ref SSD1306_initSegDisplay.
+ * @param[in] num: the value to show, scaled by 10^decimals.
+ * @retval    INVALID_PARAMS if the number does not fit the display, otherwise
+ *            a valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_updateSegDisplay(SSD1306_segDisplay_t *disp,
+	int32_t num);
+
+
+/**
+ * @brief     Sends to the LCD the digits of a seven-segment display changed
+ *            since the previous flush, each with its own
+ *            @ref SSD1306_updateArea call on the box of its changed segments,
+ *            so that far apart digits do not send the ones in between.
+ *
+ * @param[in] *disp: pointer to a display set up by
+ *            @ref SSD1306_initSegDisplay.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_flushSegDisplay(SSD1306_segDisplay_t *disp);
+
+
 /**
  * @brief     Draws a segment on the LCD given the coordinates of its two
  *            end points.
@@ -436,6 +1481,47 @@ SSD1306_status_t SSD1306_drawTriangle(uint16_t x1, uint16_t y1, uint16_t x2,
 	uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_color_t color);
 
 
+/**
+ * @brief     Draws filled triangle on LCD. The triangle is split into
+ *            horizontal spans, each written once.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ *            see updates on the LCD screen.
+ *
+ * @param[in] x1: first vertex X location. Valid input is 0 to SSD1306_WIDTH-1.
+ * @param[in] y1: first vertex Y location. Valid input is 0 to SSD1306_HEIGHT-1.
+ * @param[in] x2: second vertex X location. Valid input is 0 to SSD1306_WIDTH-1.
+ * @param[in] y2: second vertex Y location. Valid input is 0 to SSD1306_HEIGHT-1.
+ * @param[in] x3: third vertex X location. Valid input is 0 to SSD1306_WIDTH-1.
+ * @param[in] y3: third vertex Y location. Valid input is 0 to SSD1306_HEIGHT-1.
+ * @param[in] color: color to be used. This parameter can be a value of
+ * 			  @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawFilledTriangle(uint16_t x1, uint16_t y1,
+	uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_color_t color);
+
+
+/**
+ * @brief     Draws filled polygon on LCD using the even-odd rule, so both
+ *            convex and concave (even self-intersecting) shapes are
+ *            supported. Each scanline is filled with horizontal spans.
+ *            Parts outside the visible area are clipped.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ *            see updates on the LCD screen.
+ *
+ * @param[in] *points: array of vertices in drawing order. The last vertex
+ *            is joined to the first one.
+ * @param[in] n: number of vertices, between 3 and SSD1306_POLYGON_MAX_VERTICES.
+ * @param[in] color: color to be used. This parameter can be a value of
+ * 			  @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawFilledPolygon(const SSD1306_point_t *points,
+	uint8_t n, SSD1306_color_t color);
+
+
 /**
  * @brief     Draws circle on LCD.
  * @note      @ref SSD1306_updateScreen() must be called after that in order to
@@ -474,6 +1560,221 @@ SSD1306_status_t SSD1306_drawFilledCircle(int16_t x0, int16_t y0, int16_t r,
 	SSD1306_color_t color);
 
 
+/**
+ * @brief     Draws ellipse on LCD. Parts outside the visible area are
+ *            clipped.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ *            see updates on the LCD screen.
+ *
+ * @param[in] x0: X location of the center of the ellipse.
+ * @param[in] y0: Y location of the center of the ellipse.
+ * @param[in] rx: horizontal radius in pixels, up to SSD1306_WIDTH.
+ * @param[in] ry: vertical radius in pixels, up to SSD1306_HEIGHT.
+ * @param[in] color: color to be used. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawEllipse(int16_t x0, int16_t y0, int16_t rx,
+	int16_t ry, SSD1306_color_t color);
+
+
+/**
+ * @brief     Draws filled ellipse on LCD. Each scanline is written once as a
+ *            single horizontal span. Parts outside the visible area are
+ *            clipped.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ *            see updates on the LCD screen.
+ *
+ * @param[in] x0: X location of the center of the ellipse.
+ * @param[in] y0: Y location of the center of the ellipse.
+ * @param[in] rx: horizontal radius in pixels, up to SSD1306_WIDTH.
+ * @param[in] ry: vertical radius in pixels, up to SSD1306_HEIGHT.
+ * @param[in] color: color to be used. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawFilledEllipse(int16_t x0, int16_t y0, int16_t rx,
+	int16_t ry, SSD1306_color_t color);
+
+
+/**
+ * @brief     Draws rectangle with rounded corners on LCD. Parts outside the
+ *            visible area are clipped.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ *            see updates on the LCD screen.
+ *
+ * @param[in] x: top left X location.
+ * @param[in] y: top left Y location.
+ * @param[in] w: rectangle width in units of pixels.
+ * @param[in] h: rectangle height in units of pixels.
+ * @param[in] r: corner radius in pixels. It is reduced to fit half of the
+ *            shortest side.
+ * @param[in] color: color to be used. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawRoundRect(int16_t x, int16_t y, int16_t w,
+	int16_t h, int16_t r, SSD1306_color_t color);
+
+
+/**
+ * @brief     Draws filled rectangle with rounded corners on LCD. Each
+ *            scanline is written once as a single horizontal span. Parts
+ *            outside the visible area are clipped.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ *            see updates on the LCD screen.
+ *
+ * @param[in] x: top left X location.
+ * @param[in] y: top left Y location.
+ * @param[in] w: rectangle width in units of pixels.
+ * @param[in] h: rectangle height in units of pixels.
+ * @param[in] r: corner radius in pixels. It is reduced to fit half of the
+ *            shortest side.
+ * @param[in] color: color to be used. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawFilledRoundRect(int16_t x, int16_t y, int16_t w,
+	int16_t h, int16_t r, SSD1306_color_t color);
+
+
+/**
+ * @brief     Draws circular arc on LCD. Angles are in degrees, 0 pointing
+ *            right and growing clockwise; the arc goes clockwise from
+ *            start_angle to end_angle. Parts outside the visible area are
+ *            clipped.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ *            see updates on the LCD screen.
+ *
+ * @param[in] x0: X location of the center of the arc.
+ * @param[in] y0: Y location of the center of the arc.
+ * @param[in] r: arc radius in pixels, up to SSD1306_WIDTH.
+ * @param[in] start_angle: angle where the arc starts.
+ * @param[in] end_angle: angle where the arc ends. A full circle is drawn if
+ *            it is at least 360 degrees past start_angle.
+ * @param[in] color: color to be used. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawArc(int16_t x0, int16_t y0, int16_t r,
+	int16_t start_angle, int16_t end_angle, SSD1306_color_t color);
+
+
+/**
+ * @brief     Draws the outline of a circular sector on LCD: the arc as in
+ *            @ref SSD1306_drawArc plus the two radii joining its ends to the
+ *            center.
+ * @note      @ref SSD1306_updateScreen() must be called after that in order to
+ *            see updates on the LCD screen.
+ *
+ * @param[in] x0: X location of the center of the sector.
+ * @param[in] y0: Y location of the center of the sector.
+ * @param[in] r: sector radius in pixels, up to SSD1306_WIDTH.
+ * @param[in] start_angle: angle where the sector starts.
+ * @param[in] end_angle: angle where the sector ends.
+ * @param[in] color: color to be used. This parameter can be a value of
+ *            @ref SSD1306_color_t enumeration.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_drawSector(int16_t x0, int16_t y0, int16_t r,
+	int16_t start_angle, int16_t end_angle, SSD1306_color_t color);
+
+
+#if SSD1306_BAND_RENDERING
+
+/**
+ * @brief     Renders and sends the whole screen one page at a time. For each
+ *            page the band buffer is cleared, the draw callback is run with
+ *            all the drawing functions writing only the pixels that belong
+ *            to that page, and the page is sent to the LCD before the next
+ *            one is rendered.
+ * @note      The callback must draw the same content on every run and must
+ *            not rely on state kept by the driver between draws, such as
+ *            @ref SSD1306_numField_t fields.
+ *
+ * @param[in] draw: callback drawing the frame. If NULL, a black frame is
+ *            sent.
+ * @param[in] *ctx: context pointer passed to the callback.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_renderBands(SSD1306_drawCallback_t draw, void *ctx);
+
+#endif
+
+
+#if SSD1306_REGION_LOCKS
+
+/**
+ * @brief     Locks a range of pages for drawing. All the pages are locked at
+ *            once or none is, so tasks locking overlapping ranges cannot
+ *            deadlock. While the lock is held, the owner may draw inside
+ *            those pages concurrently with other tasks drawing inside their
+ *            own pages, and no flush sends them. With SSD1306_PORTRAIT a
+ *            page is a band of 8 columns. Drawing must not reach
+ *            outside the locked pages; the clip rectangle and the text
+ *            cursor are shared and must not be changed concurrently. Tasks
+ *            drawing text at the same time can use @ref SSD1306_drawTextBox,
+ *            which does not use the cursor.
+ * @note      Flushing functions lock the pages they send, so a task must
+ *            unlock its region before flushing it. Functions changing the
+ *            whole buffer, like @ref SSD1306_fill, require all the pages.
+ *
+ * @param[in] start_page: location of the upper page. Valid inputs are between
+ *            0 and SSD1306_MAX_PAGE_NUM-1.
+ * @param[in] end_page: location of the lower page. Valid inputs are between
+ *            start_page and SSD1306_MAX_PAGE_NUM-1.
+ * @param[in] wait: if 0, the function returns at once when any of the pages
+ *            is locked, otherwise it waits calling SSD1306_LOCK_WAIT.
+ * @retval    BUSY if wait is 0 and any of the pages is locked, otherwise a
+ *            valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_lockRegion(uint8_t start_page, uint8_t end_page,
+	uint8_t wait);
+
+
+/**
+ * @brief     Unlocks a range of pages locked by @ref SSD1306_lockRegion.
+ *
+ * @param[in] start_page: location of the upper page. Valid inputs are between
+ *            0 and SSD1306_MAX_PAGE_NUM-1.
+ * @param[in] end_page: location of the lower page. Valid inputs are between
+ *            start_page and SSD1306_MAX_PAGE_NUM-1.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_unlockRegion(uint8_t start_page, uint8_t end_page);
+
+#endif
+
+
+/**
+ * @brief  Turns the display off, keeping the charge pump on and the LCD
+ *         internal RAM content, so that @ref SSD1306_wake shows it again at
+ *         once.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_sleep(void);
+
+
+/**
+ * @brief  Turns the display on again after @ref SSD1306_sleep.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_wake(void);
+
+
 /**
  * @brief  Turns the LCD on.
  *
@@ -501,20 +1802,28 @@ SSD1306_status_t SSD1306_lcdOff(void);
  *
  * @param[in] addr: 7 bit slave address, left aligned, bits 7:1 are used.
  * @param[in] reg: register to write to.
- * @param[in] data: pointer to the array of bytes to be written.
+ * @param[in] data: byte to be written.
+ * @retval    NO_INIT if no transfer memory has been set with
+ *            @ref SSD1306_setMemory, I2C_ERROR if the transfer fails,
+ *            otherwise LCD_OK.
  */
-void SSD1306_I2C_Write(uint8_t addr, uint8_t reg, uint8_t data);
+SSD1306_status_t SSD1306_I2C_Write(uint8_t addr, uint8_t reg, uint8_t data);
 
 
 /**
- * @brief     Writes a single byte to the i2c slave.
+ * @brief     Writes multiple bytes to the i2c slave in a single transfer.
  *
  * @param[in] addr: 7 bit slave address, left aligned, bits 7:1 are used.
  * @param[in] reg: register to write to.
  * @param[in] data: pointer to the array of bytes to be written.
- * @param[in] count: how many bits will be written.
+ * @param[in] count: how many bytes will be written. It must be less than
+ *            SSD1306_I2C_DATATMP_SIZE.
+ * @retval    INVALID_PARAMS if count is too large, NO_INIT if no transfer
+ *            memory has been set with @ref SSD1306_setMemory, I2C_ERROR if
+ *            the transfer fails, otherwise LCD_OK.
  */
-void SSD1306_I2C_WriteMulti(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t count);
+SSD1306_status_t SSD1306_I2C_WriteMulti(uint8_t addr, uint8_t reg,
+	uint8_t *data, uint16_t count);
 
 
 /* C++ detection */
@@ -0,0 +1,128 @@
+/**
+ * @file   ssd1306_anim.h
+ * @brief  Animation player header file of SSD1306 driver module for
+ *         STM32f10x and STM32F4xx.
+ *
+ * 		   Animations are stored as keyframes plus delta frames holding only
+ * 		   the page spans that changed since the previous frame. The player
+ * 		   applies each frame to the driver buffer and sends only the changed
+ * 		   spans to the LCD. Animations are built from image sequences by the
+ * 		   tools/ssd1306_img host tool.
+ *
+ *         <b>LIBRARY USAGE:</b>
+ *         <ol>
+ *         	 <li> Initialize the LCD with @ref SSD1306_init and a player with
+ *         	      @ref SSD1306_initAnimPlayer. </li>
+ * 		     <li> Call @ref SSD1306_animStep periodically, for example from
+ * 		          the main loop, passing the current time in milliseconds.
+ * 		          Frames are shown when they are due. </li>
+ * 		   </ol>
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#ifndef __SSD1306_ANIM_H
+#define __SSD1306_ANIM_H
+
+/* C++ detection */
+#ifdef __cplusplus
+	extern C {
+#endif
+
+
+#include "ssd1306.h"
+
+
+/**
+ * @brief Animation, as generated by the tools/ssd1306_img host tool. Data
+ *        holds the frames one after the other, the first one being a
+ *        keyframe. Each frame starts with its type byte and its duration in
+ *        milliseconds (16 bits, little endian):
+ *        - keyframe (type 0x00): the 16-bit length of the data, followed by
+ *          the whole frame as RLE compressed @ref SSD1306_image_t data;
+ *        - delta frame (type 0x01): spans of changed bytes, each one made of
+ *          the page, the first column, the number of bytes n and the n new
+ *          page-format bytes, terminated by a 0xFF page.
+ */
+typedef struct {
+	uint16_t      width;      /*!< Width in pixels. */
+	uint16_t      height;     /*!< Height in pixels. */
+	uint16_t      frameCount; /*!< Number of frames. */
+	const uint8_t *data;      /*!< Frame data. */
+} SSD1306_animation_t;
+
+
+/**
+ * @brief Animation player state, owned by the application and set up by
+ *        @ref SSD1306_initAnimPlayer.
+ */
+typedef struct {
+	const SSD1306_animation_t *anim;    /*!< Animation being played. */
+	int16_t                   x;        /*!< Left X of the animation. */
+	int16_t                   y;        /*!< Top Y of the animation. */
+	uint8_t                   loop;     /*!< Restart after the last frame. */
+	uint8_t                   started;  /*!< The first frame has been shown. */
+	uint16_t                  frame;    /*!< Index of the next frame. */
+	const uint8_t             *next;    /*!< Data of the next frame. */
+	uint32_t                  due;      /*!< Time the next frame is due at. */
+} SSD1306_animPlayer_t;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief     Sets up a player for an animation. Nothing is drawn until the
+ *            first call of @ref SSD1306_animStep.
+ *
+ * @param[in] *player: pointer to the player.
+ * @param[in] *anim: pointer to the animation. It must stay valid while it
+ *            is played.
+ * @param[in] x: left X of the animation.
+ * @param[in] y: top Y of the animation.
+ * @param[in] loop: 1 to restart from the first frame after the last one.
+ * @retval    INVALID_PARAMS if the animation does not fit the visible area
+ *            or band rendering is enabled, otherwise a valid SSD1306 LCD
+ *            status as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_initAnimPlayer(SSD1306_animPlayer_t *player,
+	const SSD1306_animation_t *anim, int16_t x, int16_t y, uint8_t loop);
+
+
+/**
+ * @brief      Shows the next frame if it is due: keyframes are drawn and sent
+ *             as a whole, delta frames only update and send their changed
+ *             spans. Frames keep their pace; a frame more than its duration
+ *             late restarts the timing, so late frames are not sent in a
+ *             burst.
+ *
+ * @param[in]  *player: pointer to the player.
+ * @param[in]  now: current time in milliseconds, for example HAL_GetTick().
+ * @param[out] *done: set to 1 when the last frame of an animation that does
+ *             not loop has been shown.
+ * @retval     A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *             enumeration.
+ */
+SSD1306_status_t SSD1306_animStep(SSD1306_animPlayer_t *player, uint32_t now,
+	uint8_t *done);
+
+
+/* C++ detection */
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // __SSD1306_ANIM_H
@@ -0,0 +1,173 @@
+/**
+ * @file   ssd1306_dlist.h
+ * @brief  Retained display list header file of SSD1306 driver module for
+ *         STM32f10x and STM32F4xx.
+ *
+ * 		   The display list keeps the primitives shown on the LCD. Each item
+ * 		   has a stable ID; adding, changing or removing an item marks the
+ * 		   areas it covered and covers as damaged, and only those areas are
+ * 		   redrawn and sent to the LCD on the next flush.
+ *
+ *         <b>LIBRARY USAGE:</b>
+ *         <ol>
+ *         	 <li> Initialize the LCD with @ref SSD1306_init and the display
+ *         	      list with @ref SSD1306_dlistInit. </li>
+ * 		     <li> Add items with @ref SSD1306_dlistAdd, keeping the
+ * 		          returned IDs. </li>
+ * 		     <li> Change items with @ref SSD1306_dlistUpdate and call
+ * 		          @ref SSD1306_dlistFlush to show the changes. </li>
+ * 		   </ol>
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#ifndef __SSD1306_DLIST_H
+#define __SSD1306_DLIST_H
+
+/* C++ detection */
+#ifdef __cplusplus
+	extern C {
+#endif
+
+
+#include "ssd1306.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DISPLAY LIST SETTINGS.
+///////////////////////////////////////////////////////////////////////////////
+
+// Maximum number of items in the display list.
+#define SSD1306_DLIST_MAX_ITEMS  16
+
+// Maximum number of separate damaged areas. When more areas are damaged, the
+// ones closest to each other are merged.
+#define SSD1306_DLIST_MAX_DAMAGE 4
+
+///////////////////////////////////////////////////////////////////////////////
+
+
+/**
+ * @brief Display list item type enumeration.
+ */
+typedef enum {
+	SSD1306_ITEM_NONE = 0x00,          /*!< Unused slot. */
+	SSD1306_ITEM_RECT = 0x01,          /*!< Rectangle outline. */
+	SSD1306_ITEM_FILLED_RECT = 0x02,   /*!< Filled rectangle. */
+	SSD1306_ITEM_LINE = 0x03,          /*!< Segment. */
+	SSD1306_ITEM_CIRCLE = 0x04,        /*!< Circle outline. */
+	SSD1306_ITEM_FILLED_CIRCLE = 0x05, /*!< Filled circle. */
+	SSD1306_ITEM_TEXT = 0x06,          /*!< String. */
+	SSD1306_ITEM_BITMAP = 0x07         /*!< Row-major 1bpp bitmap. */
+} SSD1306_itemType_t;
+
+
+/**
+ * @brief Display list item. The meaning of the geometry fields depends on
+ *        the item type.
+ */
+typedef struct {
+	SSD1306_itemType_t type;  /*!< Item type. */
+	SSD1306_color_t    color; /*!< Color used to draw the item. */
+	int16_t            x;     /*!< Left X, first end point X or center X. */
+	int16_t            y;     /*!< Top Y, first end point Y or center Y. */
+	int16_t            w;     /*!< Width, second end point X or radius. */
+	int16_t            h;     /*!< Height or second end point Y. */
+	const void         *data; /*!< String for text items, bitmap for bitmap
+	                               items. It must stay valid while the item
+	                               is in the list. */
+	FontDef_t          *font; /*!< Font for text items. */
+} SSD1306_item_t;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief  Empties the display list and marks the whole screen as damaged,
+ *         so that the next flush redraws it.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_dlistInit(void);
+
+
+/**
+ * @brief      Adds an item on top of the ones already in the list. The
+ *             stacking order does not depend on the ID, which is the lowest
+ *             free one.
+ *
+ * @param[in]  *item: pointer to the item, which is copied into the list.
+ * @param[out] *id: the stable ID of the new item.
+ * @retval     INVALID_PARAMS if the list is full, otherwise a valid SSD1306
+ *             LCD status as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_dlistAdd(const SSD1306_item_t *item, uint8_t *id);
+
+
+/**
+ * @brief     Replaces an item, keeping its ID and stacking order. Both the
+ *            old and the new area of the item are marked as damaged. It must
+ *            also be called after changing the string or bitmap pointed to
+ *            by the item.
+ *
+ * @param[in] id: ID of the item.
+ * @param[in] *item: pointer to the new content of the item.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_dlistUpdate(uint8_t id, const SSD1306_item_t *item);
+
+
+/**
+ * @brief     Removes an item. Its ID may be reused by later additions.
+ *
+ * @param[in] id: ID of the item.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_dlistRemove(uint8_t id);
+
+
+/**
+ * @brief     Moves an item on top of all the others, keeping its ID.
+ *
+ * @param[in] id: ID of the item.
+ * @retval    A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *            enumeration.
+ */
+SSD1306_status_t SSD1306_dlistRaise(uint8_t id);
+
+
+/**
+ * @brief  Redraws the damaged areas and sends only them to the LCD. Each area
+ *         is cleared and every item overlapping it is drawn again, clipped
+ *         to the area, in stacking order.
+ * @note   The drawing cursor of the driver is changed by text items.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_dlistFlush(void);
+
+
+/* C++ detection */
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // __SSD1306_DLIST_H
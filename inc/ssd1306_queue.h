@@ -0,0 +1,168 @@
+/**
+ * @file   ssd1306_queue.h
+ * @brief  Draw command queue header file of SSD1306 driver module for
+ *         STM32f10x and STM32F4xx.
+ *
+ * 		   The driver state, its buffer and the i2c transmit buffer are not
+ * 		   protected against concurrent access. In a multi-task application
+ * 		   tasks and interrupt handlers post draw commands into a lock-free
+ * 		   queue instead, and a single display task renders and flushes them.
+ * 		   Every task keeps its own text cursor, so no shared cursor is
+ * 		   involved.
+ *
+ *         <b>LIBRARY USAGE:</b>
+ *         <ol>
+ *         	 <li> Initialize the LCD with @ref SSD1306_init and the queue with
+ *         	      @ref SSD1306_queueInit before the tasks are started. </li>
+ * 		     <li> Post commands from any task or interrupt handler with
+ * 		          @ref SSD1306_queuePost and @ref SSD1306_queuePuts. </li>
+ * 		     <li> Call @ref SSD1306_queueProcess from the display task, which
+ * 		          must be the only one calling the other SSD1306 functions
+ * 		          after initialization. </li>
+ * 		   </ol>
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#ifndef __SSD1306_QUEUE_H
+#define __SSD1306_QUEUE_H
+
+/* C++ detection */
+#ifdef __cplusplus
+	extern C {
+#endif
+
+
+#include "ssd1306.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+// QUEUE SETTINGS.
+///////////////////////////////////////////////////////////////////////////////
+
+// Number of commands the queue can hold. It must be a power of 2.
+#define SSD1306_QUEUE_SIZE     32
+
+// Maximum number of characters of a text command, terminator included.
+// Longer strings are split over several commands.
+#define SSD1306_QUEUE_TEXT_LEN 16
+
+///////////////////////////////////////////////////////////////////////////////
+
+
+#if (SSD1306_QUEUE_SIZE & (SSD1306_QUEUE_SIZE - 1)) != 0
+	#error SSD1306_QUEUE_SIZE must be a power of 2
+#endif
+
+
+/**
+ * @brief Draw command type enumeration.
+ */
+typedef enum {
+	SSD1306_CMD_FILL = 0x00,          /*!< Fills the whole buffer. */
+	SSD1306_CMD_PIXEL = 0x01,         /*!< Single pixel. */
+	SSD1306_CMD_LINE = 0x02,          /*!< Segment. */
+	SSD1306_CMD_RECT = 0x03,          /*!< Rectangle outline. */
+	SSD1306_CMD_FILLED_RECT = 0x04,   /*!< Filled rectangle. */
+	SSD1306_CMD_CIRCLE = 0x05,        /*!< Circle outline. */
+	SSD1306_CMD_FILLED_CIRCLE = 0x06, /*!< Filled circle. */
+	SSD1306_CMD_TEXT = 0x07,          /*!< String, copied into the command. */
+	SSD1306_CMD_BITMAP = 0x08,        /*!< Row-major 1bpp bitmap. */
+	SSD1306_CMD_UPDATE_AREA = 0x09,   /*!< Sends an area to the LCD. */
+	SSD1306_CMD_UPDATE_SCREEN = 0x0A  /*!< Sends the whole buffer to the LCD. */
+} SSD1306_cmdType_t;
+
+
+/**
+ * @brief Draw command. The meaning of the geometry fields depends on the
+ *        command type, as for the display list items.
+ */
+typedef struct {
+	SSD1306_cmdType_t type;    /*!< Command type. */
+	SSD1306_color_t   color;   /*!< Color used to draw. */
+	int16_t           x;       /*!< Left X, first end point X or center X. */
+	int16_t           y;       /*!< Top Y, first end point Y or center Y. */
+	int16_t           w;       /*!< Width, second end point X or radius. */
+	int16_t           h;       /*!< Height or second end point Y. */
+	const uint8_t     *bitmap; /*!< Bitmap. It must stay valid until the
+	                                command has been processed. */
+	FontDef_t         *font;   /*!< Font for text commands. */
+	char              text[SSD1306_QUEUE_TEXT_LEN]; /*!< Text to be drawn. */
+} SSD1306_cmd_t;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief  Empties the queue. It must be called before any task or interrupt
+ *         handler uses the queue.
+ *
+ * @retval A valid SSD1306 LCD status as described by @ref SSD1306_status_t
+ *         enumeration.
+ */
+SSD1306_status_t SSD1306_queueInit(void);
+
+
+/**
+ * @brief     Posts a command into the queue. It never blocks and may be
+ *            called concurrently by any number of tasks and interrupt
+ *            handlers.
+ *
+ * @param[in] *cmd: pointer to the command, which is copied into the queue.
+ * @retval    BUSY if the queue is full, otherwise a valid SSD1306 LCD status
+ *            as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_queuePost(const SSD1306_cmd_t *cmd);
+
+
+/**
+ * @brief         Posts a string to be drawn at the given cursor, which is
+ *                then moved past the string. Each task keeps its own
+ *                cursor. Strings longer than SSD1306_QUEUE_TEXT_LEN-1
+ *                characters are split over several commands.
+ *
+ * @param[in,out] *cursor: top left location of the string, owned by the
+ *                caller.
+ * @param[in]     *str: string to be drawn.
+ * @param[in]     *font: pointer to the font used to draw.
+ * @param[in]     color: color used to draw.
+ * @retval        BUSY if the queue got full, in which case the cursor is
+ *                past the characters posted so far, otherwise a valid SSD1306
+ *                LCD status as described by @ref SSD1306_status_t enumeration.
+ */
+SSD1306_status_t SSD1306_queuePuts(SSD1306_point_t *cursor, const char *str,
+	FontDef_t *font, SSD1306_color_t color);
+
+
+/**
+ * @brief      Runs the queued commands in posting order. It must be called by
+ *             a single task only.
+ *
+ * @param[in]  max_cmds: maximum number of commands to be run. Use 0 to run
+ *             until the queue is empty.
+ * @param[out] *count: number of commands run. It may be NULL.
+ * @retval     The status of the last failed command, or LCD_OK.
+ */
+SSD1306_status_t SSD1306_queueProcess(uint16_t max_cmds, uint16_t *count);
+
+
+/* C++ detection */
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // __SSD1306_QUEUE_H
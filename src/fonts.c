@@ -137,6 +137,26 @@ const uint16_t font_7x10 [] = {
 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000,  // |
 0x3000, 0x1000, 0x1000, 0x1000, 0x0800, 0x0800, 0x1000, 0x1000, 0x1000, 0x3000,  // }
 0x0000, 0x0000, 0x0000, 0x7400, 0x4C00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // ~
+0x3000, 0x4800, 0x4800, 0x3000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // °
+0x2000, 0x1000, 0x1000, 0x2800, 0x2800, 0x7C00, 0x4400, 0x4400, 0x0000, 0x0000,  // À
+0x2800, 0x1000, 0x2800, 0x2800, 0x2800, 0x7C00, 0x4400, 0x4400, 0x0000, 0x0000,  // Ä
+0x2000, 0x1000, 0x7C00, 0x4000, 0x7C00, 0x4000, 0x4000, 0x7C00, 0x0000, 0x0000,  // È
+0x0800, 0x1000, 0x7C00, 0x4000, 0x7C00, 0x4000, 0x4000, 0x7C00, 0x0000, 0x0000,  // É
+0x2000, 0x1000, 0x3800, 0x1000, 0x1000, 0x1000, 0x1000, 0x3800, 0x0000, 0x0000,  // Ì
+0x2000, 0x1000, 0x3800, 0x4400, 0x4400, 0x4400, 0x4400, 0x3800, 0x0000, 0x0000,  // Ò
+0x2800, 0x3800, 0x4400, 0x4400, 0x4400, 0x4400, 0x4400, 0x3800, 0x0000, 0x0000,  // Ö
+0x2000, 0x1000, 0x4400, 0x4400, 0x4400, 0x4400, 0x4400, 0x3800, 0x0000, 0x0000,  // Ù
+0x2800, 0x4400, 0x4400, 0x4400, 0x4400, 0x4400, 0x4400, 0x3800, 0x0000, 0x0000,  // Ü
+0x3000, 0x4800, 0x4800, 0x5000, 0x4800, 0x4400, 0x4400, 0x5800, 0x0000, 0x0000,  // ß
+0x2000, 0x1000, 0x3800, 0x4400, 0x3C00, 0x4400, 0x4C00, 0x3400, 0x0000, 0x0000,  // à
+0x0000, 0x2800, 0x3800, 0x4400, 0x3C00, 0x4400, 0x4C00, 0x3400, 0x0000, 0x0000,  // ä
+0x2000, 0x1000, 0x3800, 0x4400, 0x7C00, 0x4000, 0x4400, 0x3800, 0x0000, 0x0000,  // è
+0x0800, 0x1000, 0x3800, 0x4400, 0x7C00, 0x4000, 0x4400, 0x3800, 0x0000, 0x0000,  // é
+0x4000, 0x2000, 0x7000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x0000, 0x0000,  // ì
+0x2000, 0x1000, 0x3800, 0x4400, 0x4400, 0x4400, 0x4400, 0x3800, 0x0000, 0x0000,  // ò
+0x0000, 0x2800, 0x3800, 0x4400, 0x4400, 0x4400, 0x4400, 0x3800, 0x0000, 0x0000,  // ö
+0x2000, 0x1000, 0x4400, 0x4400, 0x4400, 0x4400, 0x4C00, 0x3400, 0x0000, 0x0000,  // ù
+0x0000, 0x2800, 0x4400, 0x4400, 0x4400, 0x4400, 0x4C00, 0x3400, 0x0000, 0x0000,  // ü
 };
 
 const uint16_t font_11x18 [] = {
@@ -235,8 +255,30 @@ const uint16_t font_11x18 [] = {
 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600,   // |
 0x3800, 0x3C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0E00, 0x0700, 0x0700, 0x0E00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x3C00, 0x3800,   // }
 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x3880, 0x7F80, 0x4700, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,   // ~
+0x0000, 0x1C00, 0x3600, 0x2200, 0x3600, 0x1C00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,   // °
+0x0C00, 0x0600, 0x0300, 0x0000, 0x0E00, 0x0E00, 0x1B00, 0x1B00, 0x3180, 0x3F80, 0x3F80, 0x3180, 0x60C0, 0x60C0, 0x60C0, 0x0000, 0x0000, 0x0000,   // À
+0x1B00, 0x1B00, 0x0000, 0x0E00, 0x0E00, 0x1B00, 0x1B00, 0x1B00, 0x3180, 0x3F80, 0x3F80, 0x3180, 0x60C0, 0x60C0, 0x60C0, 0x0000, 0x0000, 0x0000,   // Ä
+0x1800, 0x0C00, 0x0600, 0x0000, 0x7F80, 0x7F80, 0x6000, 0x6000, 0x7F00, 0x6000, 0x6000, 0x6000, 0x6000, 0x7F80, 0x7F80, 0x0000, 0x0000, 0x0000,   // È
+0x0600, 0x0C00, 0x1800, 0x0000, 0x7F80, 0x7F80, 0x6000, 0x6000, 0x7F00, 0x6000, 0x6000, 0x6000, 0x6000, 0x7F80, 0x7F80, 0x0000, 0x0000, 0x0000,   // É
+0x1800, 0x0C00, 0x0600, 0x0000, 0x3F00, 0x3F00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x3F00, 0x3F00, 0x0000, 0x0000, 0x0000,   // Ì
+0x1800, 0x0C00, 0x0600, 0x0000, 0x1E00, 0x3F00, 0x3300, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x3300, 0x3F00, 0x1E00, 0x0000, 0x0000, 0x0000,   // Ò
+0x3600, 0x3600, 0x0000, 0x1E00, 0x3F00, 0x3300, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x3300, 0x3F00, 0x1E00, 0x0000, 0x0000, 0x0000,   // Ö
+0x1800, 0x0C00, 0x0600, 0x0000, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x7380, 0x3F00, 0x1E00, 0x0000, 0x0000, 0x0000,   // Ù
+0x3600, 0x3600, 0x0000, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x7380, 0x3F00, 0x1E00, 0x0000, 0x0000, 0x0000,   // Ü
+0x0000, 0x1E00, 0x3F00, 0x6180, 0x6180, 0x6300, 0x6600, 0x6700, 0x6180, 0x60C0, 0x60C0, 0x60C0, 0x6180, 0x6F00, 0x6E00, 0x0000, 0x0000, 0x0000,   // ß
+0x0000, 0x0C00, 0x0600, 0x0300, 0x0000, 0x1F00, 0x3F80, 0x6180, 0x0180, 0x1F80, 0x3F80, 0x6180, 0x6380, 0x7F80, 0x38C0, 0x0000, 0x0000, 0x0000,   // à
+0x0000, 0x0000, 0x1B00, 0x1B00, 0x0000, 0x1F00, 0x3F80, 0x6180, 0x0180, 0x1F80, 0x3F80, 0x6180, 0x6380, 0x7F80, 0x38C0, 0x0000, 0x0000, 0x0000,   // ä
+0x0000, 0x1800, 0x0C00, 0x0600, 0x0000, 0x1E00, 0x3F00, 0x7300, 0x6180, 0x7F80, 0x7F80, 0x6000, 0x7180, 0x3F00, 0x1E00, 0x0000, 0x0000, 0x0000,   // è
+0x0000, 0x0600, 0x0C00, 0x1800, 0x0000, 0x1E00, 0x3F00, 0x7300, 0x6180, 0x7F80, 0x7F80, 0x6000, 0x7180, 0x3F00, 0x1E00, 0x0000, 0x0000, 0x0000,   // é
+0x0000, 0x3000, 0x1800, 0x0C00, 0x0000, 0x3E00, 0x3E00, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0000, 0x0000, 0x0000,   // ì
+0x0000, 0x1800, 0x0C00, 0x0600, 0x0000, 0x1E00, 0x3F00, 0x7380, 0x6180, 0x6180, 0x6180, 0x6180, 0x7380, 0x3F00, 0x1E00, 0x0000, 0x0000, 0x0000,   // ò
+0x0000, 0x0000, 0x3600, 0x3600, 0x0000, 0x1E00, 0x3F00, 0x7380, 0x6180, 0x6180, 0x6180, 0x6180, 0x7380, 0x3F00, 0x1E00, 0x0000, 0x0000, 0x0000,   // ö
+0x0000, 0x1800, 0x0C00, 0x0600, 0x0000, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6380, 0x7F80, 0x3D80, 0x0000, 0x0000, 0x0000,   // ù
+0x0000, 0x0000, 0x3600, 0x3600, 0x0000, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6180, 0x6380, 0x7F80, 0x3D80, 0x0000, 0x0000, 0x0000,   // ü
 };
 
+#if FONT_16X26
+
 const uint16_t font_16x26 [] = {
 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000, // Ascii = [ ]
 0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03C0,0x03C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x0000,0x0000,0x0000,0x03E0,0x03E0,0x03E0,0x0000,0x0000,0x0000,0x0000,0x0000, // Ascii = [!]
@@ -333,31 +375,208 @@ const uint16_t font_16x26 [] = {
 0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x01C0,0x0000, // Ascii = [|]
 0x3FC0,0x03E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01C0,0x03C0,0x03C0,0x01C0,0x01E0,0x00FE,0x00FE,0x01E0,0x01C0,0x03C0,0x03C0,0x01C0,0x01E0,0x01E0,0x01E0,0x01E0,0x03E0,0x3FC0,0x3F00,0x0000, // Ascii = [}]
 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x3F07,0x7FC7,0x73E7,0xF1FF,0xF07E,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000, // Ascii = [~]
+0x0000,0x0000,0x0000,0x0780,0x0FC0,0x1CE0,0x1860,0x1CE0,0x0FC0,0x0780,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [°]
+0x0700,0x0380,0x01C0,0x00E0,0x0000,0x03E0,0x03E0,0x07F0,0x07F0,0x07F0,0x0F78,0x0E7C,0x1E3C,0x3C3E,0x3FFE,0x3FFF,0x781F,0x780F,0xF00F,0xF007,0xF007,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [À]
+0x0E70,0x0E70,0x0E70,0x0000,0x03E0,0x03E0,0x07F0,0x07F0,0x07F0,0x0F78,0x0F78,0x0E7C,0x1E3C,0x3C3E,0x3FFE,0x3FFF,0x781F,0x780F,0xF00F,0xF007,0xF007,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [Ä]
+0x0380,0x01C0,0x00E0,0x0070,0x0000,0x3FFF,0x3FFF,0x3E00,0x3E00,0x3E00,0x3E00,0x3E00,0x3FFE,0x3E00,0x3E00,0x3E00,0x3E00,0x3E00,0x3E00,0x3FFF,0x3FFF,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [È]
+0x0070,0x00E0,0x01C0,0x0380,0x0000,0x3FFF,0x3FFF,0x3E00,0x3E00,0x3E00,0x3E00,0x3E00,0x3FFE,0x3E00,0x3E00,0x3E00,0x3E00,0x3E00,0x3E00,0x3FFF,0x3FFF,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [É]
+0x0380,0x01C0,0x00E0,0x0070,0x0000,0x3FFF,0x3FFF,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x03E0,0x3FFF,0x3FFF,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [Ì]
+0x0700,0x0380,0x01C0,0x00E0,0x0000,0x07F0,0x1FFC,0x3E3E,0x7C1F,0x780F,0x780F,0xF80F,0xF80F,0xF80F,0xF80F,0x780F,0x780F,0x7C1F,0x3E3E,0x1FFC,0x07F0,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [Ò]
+0x0E70,0x0E70,0x0E70,0x0000,0x07F0,0x1FFC,0x3E3E,0x7C1F,0x780F,0x780F,0xF80F,0xF80F,0xF80F,0xF80F,0xF80F,0x780F,0x780F,0x7C1F,0x3E3E,0x1FFC,0x07F0,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [Ö]
+0x0380,0x01C0,0x00E0,0x0070,0x0000,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x3C1E,0x3C1E,0x3E3E,0x1FFC,0x07F0,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [Ù]
+0x0E70,0x0E70,0x0E70,0x0000,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x7C0F,0x3C1E,0x3C1E,0x3E3E,0x1FFC,0x07F0,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [Ü]
+0x0000,0x0000,0x0000,0x0FE0,0x1FF0,0x3C78,0x3C3C,0x3C3C,0x3C78,0x3CF0,0x3DE0,0x3DF0,0x3C7C,0x3C3E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C3E,0x3DFC,0x3DF8,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [ß]
+0x0000,0x0380,0x01C0,0x00E0,0x0070,0x0000,0x0FF8,0x3FFC,0x3C7C,0x003E,0x003E,0x003E,0x07FE,0x1FFE,0x3E3E,0x7C3E,0x783E,0x7C3E,0x7C7E,0x3FFF,0x1FCF,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [à]
+0x0000,0x0000,0x0E70,0x0E70,0x0E70,0x0000,0x0FF8,0x3FFC,0x3C7C,0x003E,0x003E,0x003E,0x07FE,0x1FFE,0x3E3E,0x7C3E,0x783E,0x7C3E,0x7C7E,0x3FFF,0x1FCF,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [ä]
+0x0000,0x0380,0x01C0,0x00E0,0x0070,0x0000,0x03F8,0x0FFC,0x1F3E,0x3E1E,0x3C1F,0x7C1F,0x7FFF,0x7FFF,0x7C00,0x7C00,0x3C00,0x3E00,0x1F07,0x0FFF,0x03FE,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [è]
+0x0000,0x0070,0x00E0,0x01C0,0x0380,0x0000,0x03F8,0x0FFC,0x1F3E,0x3E1E,0x3C1F,0x7C1F,0x7FFF,0x7FFF,0x7C00,0x7C00,0x3C00,0x3E00,0x1F07,0x0FFF,0x03FE,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [é]
+0x0000,0x1C00,0x0E00,0x0700,0x0380,0x0000,0x7FE0,0x7FE0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x01E0,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [ì]
+0x0000,0x0380,0x01C0,0x00E0,0x0070,0x0000,0x07F0,0x1FFC,0x3E3E,0x3C1F,0x7C1F,0x780F,0x780F,0x780F,0x780F,0x780F,0x7C1F,0x3C1F,0x3E3E,0x1FFC,0x07F0,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [ò]
+0x0000,0x0000,0x0E70,0x0E70,0x0E70,0x0000,0x07F0,0x1FFC,0x3E3E,0x3C1F,0x7C1F,0x780F,0x780F,0x780F,0x780F,0x780F,0x7C1F,0x3C1F,0x3E3E,0x1FFC,0x07F0,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [ö]
+0x0000,0x0380,0x01C0,0x00E0,0x0070,0x0000,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C3E,0x3C7E,0x3EFE,0x1FFE,0x0FDE,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [ù]
+0x0000,0x0000,0x0E70,0x0E70,0x0E70,0x0000,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C1E,0x3C3E,0x3C7E,0x3EFE,0x1FFE,0x0FDE,0x0000,0x0000,0x0000,0x0000,0x0000, // Latin1 = [ü]
+};
+
+#endif
+
+
+/**
+ * @brief Glyph offsets of the Latin-1 code points from U+00B0 to U+00FC: the
+ *        degree sign and the accented letters of German and Italian.
+ */
+static const uint8_t font_latin1_map[] = {
+	0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // U+00B0
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // U+00B8
+	0x01, 0xFF, 0xFF, 0xFF, 0x02, 0xFF, 0xFF, 0xFF, // U+00C0
+	0x03, 0x04, 0xFF, 0xFF, 0x05, 0xFF, 0xFF, 0xFF, // U+00C8
+	0xFF, 0xFF, 0x06, 0xFF, 0xFF, 0xFF, 0x07, 0xFF, // U+00D0
+	0xFF, 0x08, 0xFF, 0xFF, 0x09, 0xFF, 0xFF, 0x0A, // U+00D8
+	0x0B, 0xFF, 0xFF, 0xFF, 0x0C, 0xFF, 0xFF, 0xFF, // U+00E0
+	0x0D, 0x0E, 0xFF, 0xFF, 0x0F, 0xFF, 0xFF, 0xFF, // U+00E8
+	0xFF, 0xFF, 0x10, 0xFF, 0xFF, 0xFF, 0x11, 0xFF, // U+00F0
+	0xFF, 0x12, 0xFF, 0xFF, 0x13                    // U+00F8
+};
+
+/**
+ * @brief Code point ranges shared by the built-in fonts: printable ASCII
+ *        followed by the Latin-1 glyphs.
+ */
+static const FontRange_t font_ranges[] = {
+	{ FONT_FIRST_CHAR, FONT_LAST_CHAR, 0, NULL },
+	{ 0x00B0, 0x00FC, FONT_LAST_CHAR - FONT_FIRST_CHAR + 1, font_latin1_map }
 };
 
 
 FontDef_t FontDef_7x10 = {
 	.fontWidth = 7,
 	.fontHeight = 10,
-	.data = font_7x10
+	.data = font_7x10,
+	.ranges = font_ranges,
+	.rangeCount = 2,
+	.fallback = '?'
 };
 
 FontDef_t FontDef_11x18 = {
 	.fontWidth = 11,
 	.fontHeight = 18,
-	.data = font_11x18
+	.data = font_11x18,
+	.ranges = font_ranges,
+	.rangeCount = 2,
+	.fallback = '?'
 };
 
+#if FONT_16X26
 FontDef_t FontDef_16x26 = {
 	.fontWidth = 16,
 	.fontHeight = 26,
-	.data = font_16x26
+	.data = font_16x26,
+	.ranges = font_ranges,
+	.rangeCount = 2,
+	.fallback = '?'
 };
+#endif
+
+
+/**
+ * @brief Looks up the glyph of a code point without the fallback.
+ * @retval Index of the glyph in the font data, or -1.
+ */
+static int16_t find_glyph(const FontDef_t *font, uint16_t cp) {
+	// Fonts without a range table hold printable ASCII only.
+	if (font->ranges == NULL) {
+		if (cp < FONT_FIRST_CHAR || cp > FONT_LAST_CHAR) {
+			return -1;
+		}
+		return cp - FONT_FIRST_CHAR;
+	}
+
+	for (uint8_t i = 0; i < font->rangeCount; i++) {
+		const FontRange_t *r = &font->ranges[i];
+
+		if (cp < r->first || cp > r->last) {
+			continue;
+		}
+
+		if (r->map == NULL) {
+			return r->glyph + (cp - r->first);
+		}
+
+		if (r->map[cp - r->first] == FONT_NO_GLYPH) {
+			return -1;
+		}
+
+		return r->glyph + r->map[cp - r->first];
+	}
+
+	return -1;
+}
 
 
 void get_string_size(char* str, FontStringSize_t *sizeStruct, FontDef_t *font) {
+	const char *s = str;
+	uint16_t n = 0;
+
+	// Every code point takes the width of a glyph.
+	while (get_code_point(&s)) {
+		n++;
+	}
+
 	sizeStruct->height = font->fontHeight;
-	sizeStruct->length = font->fontWidth * strlen(str);
+	sizeStruct->length = font->fontWidth * n;
 
 	return;
 }
+
+
+void get_string_size_rotated(char *str, FontStringSize_t *sizeStruct,
+	FontDef_t *font, uint8_t rotation) {
+
+	get_string_size(str, sizeStruct, font);
+
+	// Odd quarter turns run the string along Y.
+	if (rotation & 0x01) {
+		uint16_t length = sizeStruct->length;
+
+		sizeStruct->length = sizeStruct->height;
+		sizeStruct->height = length;
+	}
+}
+
+
+uint16_t get_code_point(const char **str) {
+	const uint8_t *s = (const uint8_t *)*str;
+	uint16_t cp;
+	uint8_t len;
+
+	if (s[0] == 0x00) {
+		return 0;
+	}
+
+	// The lead byte gives the length of the sequence.
+	if (s[0] < 0x80) {
+		*str += 1;
+		return s[0];
+	} else if ((s[0] & 0xE0) == 0xC0) {
+		cp = s[0] & 0x1F;
+		len = 2;
+	} else if ((s[0] & 0xF0) == 0xE0) {
+		cp = s[0] & 0x0F;
+		len = 3;
+	} else if ((s[0] & 0xF8) == 0xF0) {
+		cp = 0;
+		len = 4;
+	} else {
+		*str += 1;
+		return FONT_REPLACEMENT_CHAR;
+	}
+
+	for (uint8_t i = 1; i < len; i++) {
+		// A truncated sequence is replaced up to the offending byte, which
+		// starts the next code point.
+		if ((s[i] & 0xC0) != 0x80) {
+			*str += i;
+			return FONT_REPLACEMENT_CHAR;
+		}
+		cp = (cp << 6) | (s[i] & 0x3F);
+	}
+
+	*str += len;
+
+	// Rejects overlong encodings and code points that do not fit 16 bits.
+	if (len == 4 || (len == 2 && cp < 0x80) || (len == 3 && cp < 0x800)) {
+		return FONT_REPLACEMENT_CHAR;
+	}
+
+	return cp;
+}
+
+
+int16_t get_glyph_index(const FontDef_t *font, uint16_t cp) {
+	int16_t glyph = find_glyph(font, cp);
+
+	if (glyph < 0 && font->fallback != 0) {
+		glyph = find_glyph(font, font->fallback);
+	}
+
+	return glyph;
+}
@@ -40,6 +40,10 @@
 
 #include "ssd1306.h"
 
+#if SSD1306_REGION_LOCKS
+	#include <stdatomic.h>
+#endif
+
 
 /* Write command macro. */
 #define SSD1306_WRITECOMMAND(command) SSD1306_I2C_Write(SSD1306_I2C_ADDR, 0x00, (command))
@@ -47,787 +51,3928 @@
 /* Write data macro. */
 #define SSD1306_WRITEDATA(data) SSD1306_I2C_Write(SSD1306_I2C_ADDR, 0x40, (data))
 
-/* Absolute value macro. */
-#define ABS(x) ((x) > 0 ? (x) : -(x))
+/* Shadow invalidation macro, for commands changing the LCD RAM content. */
+#if SSD1306_SHADOW_FLUSH
+	#define SSD1306_SHADOW_INVALIDATE() (SSD1306_ShadowValid = 0)
+#else
+	#define SSD1306_SHADOW_INVALIDATE()
+#endif
+
+/* Page lock macros, used by the flushing functions. */
+#if SSD1306_REGION_LOCKS
+	#define SSD1306_LOCK_PAGES(first, last) \
+		SSD1306_lockPages(SSD1306_pageMask((first), (last)))
+	#define SSD1306_UNLOCK_PAGES(first, last) \
+		SSD1306_unlockPages(SSD1306_pageMask((first), (last)))
+#else
+	#define SSD1306_LOCK_PAGES(first, last)
+	#define SSD1306_UNLOCK_PAGES(first, last)
+#endif
+
+/* Positions of the state dependent commands in SSD1306_InitCmds. */
+#define SSD1306_INIT_COM_SCAN  4
+#define SSD1306_INIT_CONTRAST  8
+#define SSD1306_INIT_SEG_REMAP 10
+#define SSD1306_INIT_INVERT    11
+
+/* Bytes on the wire (address byte included) of a full frame sent by pages:
+ * three single command transactions plus one data transaction per page. */
+#define SSD1306_FULL_FLUSH_BYTES \
+	(SSD1306_MAX_PAGE_NUM * (3 * 3 + 2 + SSD1306_LCD_WIDTH))
+
+/* Bytes on the wire needed to start a new data run: one transaction with
+ * the page and column commands plus the header of the data transaction. */
+#define SSD1306_RUN_SETUP_BYTES (2 + 3 + 2)
+
+/* Bytes on the wire needed to send a column strip: one transaction switching
+ * to vertical addressing and setting the column and page windows, the header
+ * of the data transaction and one transaction back to page addressing. */
+#define SSD1306_STRIP_SETUP_BYTES ((2 + 8) + 2 + (2 + 2))
 
 
 ///////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES.
 ///////////////////////////////////////////////////////////////////////////////
 
+#if SSD1306_BAND_RENDERING
+
+#if SSD1306_EXTERNAL_MEMORY
+
+/**
+ * @brief Band buffer holding a single page, provided by the application. The
+ *        first byte is the i2c data control byte, so that the page is sent
+ *        without copying it.
+ */
+static uint8_t *SSD1306_Band;
+
+/**
+ * @brief SSD1306 data buffer, the page being rendered.
+ */
+static uint8_t *SSD1306_Buffer;
+
+#else
+
+/**
+ * @brief Private band buffer holding a single page. The first byte is the
+ *        i2c data control byte, so that the page is sent without copying it.
+ */
+static uint8_t SSD1306_Band[SSD1306_BUFFER_MEMORY_SIZE] = { 0x40 };
+
+/**
+ * @brief Private SSD1306 data buffer, the page being rendered.
+ */
+static uint8_t * const SSD1306_Buffer = &SSD1306_Band[1];
+
+#endif
+
+/**
+ * @brief Page currently held by the band buffer.
+ */
+static uint8_t SSD1306_BandPage;
+
+#elif SSD1306_EXTERNAL_MEMORY
+
+/**
+ * @brief SSD1306 data buffer, provided by the application.
+ */
+static uint8_t *SSD1306_Buffer;
+
+#else
+
 /**
  * @brief Private SSD1306 data buffer.
  */
 static uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
 
+#endif
+
+#if SSD1306_PORTRAIT
+/**
+ * @brief Private LCD RAM page built from the transposed driver buffer.
+ */
+static uint8_t SSD1306_LcdPage[SSD1306_LCD_WIDTH];
+#endif
+
+/**
+ * @brief Segment remap and COM scan direction commands of each rotation.
+ *        The drawing area of the portrait rotations is transposed, so one
+ *        of the two axes is mirrored.
+ */
+static const uint8_t SSD1306_RotationCmds[4][2] = {
+	{ 0xA1, 0xC8 }, // 0 degrees.
+	{ 0xA0, 0xC8 }, // 90 degrees.
+	{ 0xA0, 0xC0 }, // 180 degrees.
+	{ 0xA1, 0xC0 }  // 270 degrees.
+};
+
+/**
+ * @brief LCD initialization commands, sent in a single transaction.
+ */
+static const uint8_t SSD1306_InitCmds[] = {
+	0xAE,       // Display off.
+	0x20, 0x02, // Page addressing mode.
+	0xB0,       // Page start address.
+	0xC8,       // COM output scan direction, set by the rotation.
+	0x00, 0x10, // Column start address.
+	0x40,       // Start line address.
+	0x81, 0xFF, // Contrast.
+	0xA1,       // Segment remap, set by the rotation.
+	0xA6,       // Normal display, set by the inversion.
+	0xA8, 0x3F, // Multiplex ratio.
+	0xA4,       // Output follows RAM content.
+	0xD3, 0x00, // No display offset.
+	0xD5, 0xF0, // Display clock divide ratio and oscillator frequency.
+	0xD9, 0x22, // Pre-charge period.
+	0xDA, 0x12, // COM pins hardware configuration.
+	0xDB, 0x20, // VCOMH deselect level, 0.77xVcc.
+	0x8D, 0x14, // Charge pump enabled.
+	0xAF,       // Display on.
+	SSD1306_DEACTIVATE_SCROLL
+};
+
+// The initialization table is sent in a single transaction.
+_Static_assert(sizeof(SSD1306_InitCmds) < SSD1306_I2C_DATATMP_SIZE,
+	"SSD1306_I2C_DATATMP_SIZE is too small for the initialization table");
+
 /**
  * @brief Private structure to store the LCD properties.
  */
 static SSD1306_t SSD1306;
 
+#if SSD1306_EXTERNAL_MEMORY
+/**
+ * @brief Temporary buffer to store data to be transmitted to the LCD,
+ *        provided by the application.
+ */
+static uint8_t *data_tmp;
+#else
+/**
+ * @brief Temporary buffer to store data to be transmitted to the LCD.
+ */
+static uint8_t data_tmp[SSD1306_I2C_DATATMP_SIZE];
+#endif
+
+#if SSD1306_SHADOW_FLUSH
+
+/**
+ * @brief Private copy of the LCD internal RAM content.
+ */
+static uint8_t SSD1306_Shadow[SSD1306_LCD_WIDTH * SSD1306_LCD_HEIGHT / 8];
+
+/**
+ * @brief The shadow matches the LCD internal RAM.
+ */
+static uint8_t SSD1306_ShadowValid;
+
+/**
+ * @brief Private flush counters.
+ */
+static SSD1306_flushStats_t SSD1306_FlushStats;
+
+#endif
+
+/**
+ * @brief Private state of the incremental flush.
+ */
+static struct {
+	uint8_t active; /*!< A flush is in progress. */
+	uint8_t page;   /*!< Page to be resumed. */
+	int16_t col;    /*!< Column to be resumed. */
+} SSD1306_Flush;
+
+/**
+ * @brief Private clipping rectangle, inclusive bounds. Drawing functions do
+ *        not write pixels outside of it.
+ */
+static struct {
+	int16_t x0, y0, x1, y1;
+} SSD1306_Clip = { 0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1 };
+
+#if SSD1306_REGION_LOCKS
+/**
+ * @brief Private page locks, one bit per page.
+ */
+static atomic_uint SSD1306_PageLocks;
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////////
-// FUNCTION DEFINITIONS.
+// PRIVATE FUNCTIONS.
 ///////////////////////////////////////////////////////////////////////////////
 
-SSD1306_status_t SSD1306_init(I2C_HandleTypeDef *i2c_ptr) {
-	// Saves the used i2c peripheral and keeps track of it.
-	SSD1306.i2c_ptr = i2c_ptr;
+/**
+ * @brief Returns a pointer to the first byte of the given page in the driver
+ *        buffer, or NULL if the page is not held by the buffer (only in band
+ *        rendering mode, when another page is being rendered).
+ */
+static inline uint8_t *SSD1306_page(uint8_t page) {
+#if SSD1306_BAND_RENDERING
+	return (page == SSD1306_BandPage) ? SSD1306_Buffer : NULL;
+#else
+	return &SSD1306_Buffer[page * SSD1306_WIDTH];
+#endif
+}
 
-	// Resets the LCD structure.
-	SSD1306.currentX = 0;
-	SSD1306.currentY = 0;
-	SSD1306.initialized = 0;
 
-	if (HAL_I2C_IsDeviceReady(SSD1306.i2c_ptr, SSD1306_I2C_ADDR, 10,
-		SSD1306_I2C_TIMEOUT) != HAL_OK) {
-		return I2C_ERROR;
+/**
+ * @brief Returns the rows of the given page that lie inside the clipping
+ *        rectangle, bit 0 being the top row of the page.
+ */
+static inline uint8_t SSD1306_pageClip(uint8_t page) {
+	int16_t top = page * 8;
+	uint8_t m = 0xFF;
+
+	if (top > SSD1306_Clip.y1 || top + 7 < SSD1306_Clip.y0) {
+		return 0;
+	}
+
+	if (SSD1306_Clip.y0 > top) {
+		m &= 0xFF << (SSD1306_Clip.y0 - top);
 	}
+	if (SSD1306_Clip.y1 < top + 7) {
+		m &= 0xFF >> (top + 7 - SSD1306_Clip.y1);
+	}
+
+	return m;
+}
 
-	HAL_Delay(10);
-
-	/* Initializes the LCD. */
-	SSD1306_WRITECOMMAND(0xAE); //display off
-	SSD1306_WRITECOMMAND(0x20); //Set Memory Addressing Mode
-	SSD1306_WRITECOMMAND(0x10); //00,Horizontal Addressing Mode;01,Vertical Addressing Mode;10,Page Addressing Mode (RESET);11,Invalid
-	SSD1306_WRITECOMMAND(0xB0); //Set Page Start Address for Page Addressing Mode,0-7
-	SSD1306_WRITECOMMAND(0xC8); //Set COM Output Scan Direction
-	SSD1306_WRITECOMMAND(0x00); //--set low column address
-	SSD1306_WRITECOMMAND(0x10); //--set high column address
-	SSD1306_WRITECOMMAND(0x40); //--set start line address
-	SSD1306_WRITECOMMAND(0x81); //--set contrast control register
-	SSD1306_WRITECOMMAND(0xFF);
-	SSD1306_WRITECOMMAND(0xA1); //--set segment re-map 0 to 127
-	SSD1306_WRITECOMMAND(0xA6); //--set normal display
-	SSD1306_WRITECOMMAND(0xA8); //--set multiplex ratio(1 to 64)
-	SSD1306_WRITECOMMAND(0x3F); //
-	SSD1306_WRITECOMMAND(0xA4); //0xa4,Output follows RAM content;0xa5,Output ignores RAM content
-	SSD1306_WRITECOMMAND(0xD3); //-set display offset
-	SSD1306_WRITECOMMAND(0x00); //-not offset
-	SSD1306_WRITECOMMAND(0xD5); //--set display clock divide ratio/oscillator frequency
-	SSD1306_WRITECOMMAND(0xF0); //--set divide ratio
-	SSD1306_WRITECOMMAND(0xD9); //--set pre-charge period
-	SSD1306_WRITECOMMAND(0x22); //
-	SSD1306_WRITECOMMAND(0xDA); //--set com pins hardware configuration
-	SSD1306_WRITECOMMAND(0x12);
-	SSD1306_WRITECOMMAND(0xDB); //--set vcomh
-	SSD1306_WRITECOMMAND(0x20); //0x20,0.77xVcc
-	SSD1306_WRITECOMMAND(0x8D); //--set DC-DC enable
-	SSD1306_WRITECOMMAND(0x14); //
-	SSD1306_WRITECOMMAND(0xAF); //--turn on SSD1306 panel
 
-	SSD1306_WRITECOMMAND(SSD1306_DEACTIVATE_SCROLL);
+/**
+ * @brief Updates a buffer byte. Bits in m are the ones covered by the drawing,
+ *        bits in d the foreground pixels among them.
+ */
+static inline void SSD1306_writeByte(uint8_t *dst, uint8_t m, uint8_t d,
+	SSD1306_color_t color, SSD1306_textMode_t mode) {
+
+	uint8_t set, clr;
+
+	if (color == SSD1306_COLOR_WHITE) {
+		set = d;
+		clr = (mode == SSD1306_TEXT_OPAQUE) ? (m & ~d) : 0;
+	} else {
+		set = (mode == SSD1306_TEXT_OPAQUE) ? (m & ~d) : 0;
+		clr = d;
+	}
+
+	*dst = (*dst & ~clr) | set;
+}
+
+
+/**
+ * @brief Word kernel updating n consecutive buffer bytes: the bits in clr are
+ *        cleared, the bits in set are set and then the bits in flip are
+ *        inverted. Whole 32-bit words are processed once dst is aligned.
+ */
+static void SSD1306_maskBytes(uint8_t *dst, uint16_t n, uint8_t set,
+	uint8_t clr, uint8_t flip) {
+
+	while (n && ((uintptr_t)dst & 0x03)) {
+		*dst = ((*dst & ~clr) | set) ^ flip;
+		dst++;
+		n--;
+	}
+
+	if (n >= 4) {
+		uint32_t s = set * 0x01010101u;
+		uint32_t c = clr * 0x01010101u;
+		uint32_t f = flip * 0x01010101u;
+
+		for (; n >= 4; n -= 4, dst += 4) {
+			uint32_t w;
+
+			memcpy(&w, dst, 4);
+			w = ((w & ~c) | s) ^ f;
+			memcpy(dst, &w, 4);
+		}
+	}
+
+	while (n--) {
+		*dst = ((*dst & ~clr) | set) ^ flip;
+		dst++;
+	}
+}
+
+
+/**
+ * @brief Loops of @ref SSD1306_composeBytes for one raster operation, given
+ *        as an expression of the buffer bits d, the source bits s and the
+ *        mask k, byte by byte until dst is aligned, then 32 bits at a time.
+ */
+#define SSD1306_COMPOSE_LOOPS(expr) do { \
+	uint32_t kw = m * 0x01010101u, iw = inv * 0x01010101u; \
+	\
+	while (n && ((uintptr_t)dst & 0x03)) { \
+		uint8_t d = *dst, s = *src++ ^ inv, k = m; \
+		*dst++ = (uint8_t)(expr); \
+		n--; \
+	} \
+	\
+	for (; n >= 4; n -= 4, dst += 4, src += 4) { \
+		uint32_t d, s, k = kw; \
+		memcpy(&d, dst, 4); \
+		memcpy(&s, src, 4); \
+		s ^= iw; \
+		d = (expr); \
+		memcpy(dst, &d, 4); \
+	} \
+	\
+	while (n--) { \
+		uint8_t d = *dst, s = *src++ ^ inv, k = m; \
+		*dst++ = (uint8_t)(expr); \
+	} \
+} while (0)
+
+
+/**
+ * @brief Word kernel composing n source bytes, inverted by inv, into n
+ *        consecutive buffer bytes with the given raster operation. Only the
+ *        bits in m are changed. Each operation has its own loops, so the
+ *        inner loop holds only the operation itself.
+ */
+static void SSD1306_composeBytes(uint8_t *dst, const uint8_t *src, uint16_t n,
+	uint8_t m, uint8_t inv, SSD1306_rop_t rop) {
+
+	switch (rop) {
+		case SSD1306_ROP_COPY:
+			SSD1306_COMPOSE_LOOPS((d & ~k) | (s & k));
+			break;
+		case SSD1306_ROP_OR:
+			SSD1306_COMPOSE_LOOPS(d | (s & k));
+			break;
+		case SSD1306_ROP_AND:
+			SSD1306_COMPOSE_LOOPS(d & (s | ~k));
+			break;
+		case SSD1306_ROP_XOR:
+			SSD1306_COMPOSE_LOOPS(d ^ (s & k));
+			break;
+	}
+}
+
+
+/**
+ * @brief Applies @ref SSD1306_maskBytes to the rectangle between (x0, y0) and
+ *        (x1, y1), both included, one page at a time. Pixels outside the
+ *        clipping rectangle are discarded.
+ */
+static void SSD1306_maskRegion(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+	uint8_t set, uint8_t clr, uint8_t flip) {
+
+	if (x0 < SSD1306_Clip.x0) x0 = SSD1306_Clip.x0;
+	if (y0 < SSD1306_Clip.y0) y0 = SSD1306_Clip.y0;
+	if (x1 > SSD1306_Clip.x1) x1 = SSD1306_Clip.x1;
+	if (y1 > SSD1306_Clip.y1) y1 = SSD1306_Clip.y1;
+
+	if (x0 > x1 || y0 > y1) {
+		return;
+	}
+
+	for (uint8_t page = y0 >> 3; page <= (y1 >> 3); page++) {
+		uint8_t *dst = SSD1306_page(page);
+		uint8_t m = 0xFF;
+
+		if (dst == NULL) {
+			continue;
+		}
+
+		// Rows of the page covered by the rectangle.
+		if (page == (y0 >> 3)) {
+			m &= 0xFF << (y0 & 0x07);
+		}
+		if (page == (y1 >> 3)) {
+			m &= 0xFF >> (7 - (y1 & 0x07));
+		}
+
+		SSD1306_maskBytes(dst + x0, x1 - x0 + 1, set & m, clr & m, flip & m);
+	}
+}
+
+
+/**
+ * @brief Fills the rectangle between (x0, y0) and (x1, y1), both included,
+ *        with the given color. Pixels outside the clipping rectangle are
+ *        discarded.
+ */
+static inline void SSD1306_fillRegion(int16_t x0, int16_t y0, int16_t x1,
+	int16_t y1, SSD1306_color_t color) {
+
+	if (color == SSD1306_COLOR_WHITE) {
+		SSD1306_maskRegion(x0, y0, x1, y1, 0xFF, 0x00, 0x00);
+	} else {
+		SSD1306_maskRegion(x0, y0, x1, y1, 0x00, 0xFF, 0x00);
+	}
+}
+
+
+#ifdef SSD1306_SPAN_HOOK
+/* Called with every span actually written, for example by host benchmarks
+   built with -DSSD1306_SPAN_HOOK=function_name. */
+extern void SSD1306_SPAN_HOOK(int16_t x0, int16_t x1, int16_t y);
+#endif
+
+/**
+ * @brief Fills the horizontal span between x0 and x1 (both included) on the
+ *        given scanline. All the pixels of a span share the same bit within
+ *        their page, so the span is written as a run of byte operations.
+ *        Pixels outside the clipping rectangle are discarded.
+ */
+static void SSD1306_fillSpan(int16_t x0, int16_t x1, int16_t y,
+	SSD1306_color_t color) {
+
+	if (y < SSD1306_Clip.y0 || y > SSD1306_Clip.y1) {
+		return;
+	}
+
+	if (x0 > x1) {
+		int16_t tmp = x0;
+		x0 = x1;
+		x1 = tmp;
+	}
+
+	if (x1 < SSD1306_Clip.x0 || x0 > SSD1306_Clip.x1) {
+		return;
+	}
+
+	if (x0 < SSD1306_Clip.x0) x0 = SSD1306_Clip.x0;
+	if (x1 > SSD1306_Clip.x1) x1 = SSD1306_Clip.x1;
+
+	uint8_t bit = 1 << (y & 0x07);
+	uint8_t *dst = SSD1306_page(y >> 3);
+
+	if (dst == NULL) {
+		return;
+	}
+
+#ifdef SSD1306_SPAN_HOOK
+	SSD1306_SPAN_HOOK(x0, x1, y);
+#endif
+
+	dst += x0;
+	uint8_t *end = dst + (x1 - x0) + 1;
+
+	if (color == SSD1306_COLOR_WHITE) {
+		while (dst < end) {
+			*dst++ |= bit;
+		}
+	} else {
+		bit = ~bit;
+		while (dst < end) {
+			*dst++ &= bit;
+		}
+	}
+}
+
+
+/**
+ * @brief Draws a clipped line between two points with Bresenham's algorithm.
+ *        Unlike @ref SSD1306_drawLine, the end points may lie outside the
+ *        visible area.
+ */
+static void SSD1306_plotLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+	SSD1306_color_t color) {
+
+	int16_t dx = (x0 < x1) ? (x1 - x0) : (x0 - x1);
+	int16_t dy = (y0 < y1) ? (y0 - y1) : (y1 - y0);
+	int16_t sx = (x0 < x1) ? 1 : -1;
+	int16_t sy = (y0 < y1) ? 1 : -1;
+	int16_t err = dx + dy;
+
+	while (1) {
+		SSD1306_fillSpan(x0, x0, y0, color);
+		if (x0 == x1 && y0 == y1) {
+			break;
+		}
+
+		int16_t e2 = 2 * err;
+		if (e2 >= dy) {
+			err += dy;
+			x0 += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			y0 += sy;
+		}
+	}
+}
+
+
+/**
+ * @brief Draws an ellipse whose left and right halves are centered on cxl and
+ *        cxr and whose upper and lower halves are centered on cyt and cyb.
+ *        Equal centers give an ellipse, different ones a rounded rectangle.
+ *        The quadrants are walked from the poles towards the equator,
+ *        widening the half span dx of each row as long as the next pixel
+ *        is inside, so every scanline is visited once. Filled shapes write
+ *        one span per row, outlines the run of pixels joining the row to
+ *        the previous one.
+ */
+static void SSD1306_drawRoundShape(int16_t cxl, int16_t cxr, int16_t cyt,
+	int16_t cyb, int16_t rx, int16_t ry, uint8_t filled, SSD1306_color_t color) {
+
+	// Rounded rectangles accept radii up to half of any int16_t side, whose
+	// fourth power does not fit in 32 bits.
+	int64_t rx2 = (int64_t)rx * rx, ry2 = (int64_t)ry * ry;
+
+	// Half a pixel of tolerance, the same as the midpoint circle algorithm.
+	int64_t limit = rx2 * ry2 + (int64_t)rx * ry * (rx + ry) / 2;
+	int16_t dx = 0, prev = -1;
+
+	for (int16_t dy = ry; dy >= 0; dy--) {
+		while (dx < rx &&
+			(int64_t)(dx + 1) * (dx + 1) * ry2 + (int64_t)dy * dy * rx2 <= limit) {
+			dx++;
+		}
+
+		int16_t rows[2] = { cyt - dy, cyb + dy };
+
+		for (uint8_t i = 0; i < ((rows[0] == rows[1]) ? 1 : 2); i++) {
+			if (filled || prev < 0) {
+				SSD1306_fillSpan(cxl - dx, cxr + dx, rows[i], color);
+			} else {
+				int16_t run = dx - prev - 1;
+				if (run < 0) {
+					run = 0;
+				}
+
+				SSD1306_fillSpan(cxl - dx, cxl - dx + run, rows[i], color);
+				SSD1306_fillSpan(cxr + dx - run, cxr + dx, rows[i], color);
+			}
+		}
+
+		prev = dx;
+	}
+
+	// Straight part between the upper and lower halves.
+	for (int16_t y = cyt + 1; y < cyb; y++) {
+		if (filled) {
+			SSD1306_fillSpan(cxl - dx, cxr + dx, y, color);
+		} else {
+			SSD1306_fillSpan(cxl - dx, cxl - dx, y, color);
+			SSD1306_fillSpan(cxr + dx, cxr + dx, y, color);
+		}
+	}
+}
+
+
+/**
+ * @brief 8x8 Bayer thresholds, indexed by row and column mod 8. A pixel is
+ *        white if its gray level is above the threshold.
+ */
+static const uint8_t SSD1306_BayerTable[8][8] = {
+	{   2, 130,  34, 162,  10, 138,  42, 170 },
+	{ 194,  66, 226,  98, 202,  74, 234, 106 },
+	{  50, 178,  18, 146,  58, 186,  26, 154 },
+	{ 242, 114, 210,  82, 250, 122, 218,  90 },
+	{  14, 142,  46, 174,   6, 134,  38, 166 },
+	{ 206,  78, 238, 110, 198,  70, 230, 102 },
+	{  62, 190,  30, 158,  54, 182,  22, 150 },
+	{ 254, 126, 222,  94, 246, 118, 214,  86 }
+};
+
+
+/**
+ * @brief Quarter-wave sine table, sin(0..90 degrees) scaled by 2^14.
+ */
+static const int16_t SSD1306_SinTable[91] = {
+	0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+	2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+	5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+	8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+	10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+	12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+	14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+	15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+	16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+	16384
+};
+
+
+/**
+ * @brief Returns the sine of the given angle in degrees, scaled by 2^14.
+ */
+static int16_t SSD1306_sin(int16_t deg) {
+	deg %= 360;
+	if (deg < 0) {
+		deg += 360;
+	}
+
+	if (deg <= 90) return SSD1306_SinTable[deg];
+	if (deg <= 180) return SSD1306_SinTable[180 - deg];
+	if (deg <= 270) return -SSD1306_SinTable[deg - 180];
+
+	return -SSD1306_SinTable[360 - deg];
+}
+
+
+/**
+ * @brief Returns the cosine of the given angle in degrees, scaled by 2^14.
+ */
+static int16_t SSD1306_cos(int16_t deg) {
+	return SSD1306_sin((deg % 360) + 90);
+}
+
+
+/**
+ * @brief Writes a vertical run of pixels into a single buffer column. Bit 0 of
+ *        bits is the pixel at y, bit height-1 the lowest one. The run is
+ *        split over the pages it crosses and each page byte is updated with
+ *        one masked read-modify-write. Pixels outside the clipping rectangle
+ *        are discarded.
+ */
+static void SSD1306_writeColumn(uint16_t x, uint16_t y, uint32_t bits,
+	uint8_t height, SSD1306_color_t color, SSD1306_textMode_t mode) {
+
+	if (x < SSD1306_Clip.x0 || x > SSD1306_Clip.x1) {
+		return;
+	}
+
+	uint8_t shift = y & 0x07;
+	uint64_t mask = ((((uint64_t)1) << height) - 1) << shift;
+	uint64_t data = ((uint64_t)bits << shift) & mask;
+
+	for (uint8_t page = y >> 3; page < SSD1306_HEIGHT / 8 && mask; page++) {
+		uint8_t *dst = SSD1306_page(page);
+
+		uint8_t m = (uint8_t)mask & SSD1306_pageClip(page);
+
+		if (dst != NULL && m) {
+			SSD1306_writeByte(dst + x, m, (uint8_t)data & m, color, mode);
+		}
+
+		mask >>= 8;
+		data >>= 8;
+	}
+}
+
+
+/**
+ * @brief Transposes the row-major data of a glyph into one bit mask per
+ *        column, bit 0 being the top row. Index is the glyph position in the
+ *        font data, as returned by @ref get_glyph_index.
+ */
+static void SSD1306_decodeGlyph(int16_t index, FontDef_t *font, uint32_t *cols) {
+	const uint16_t *glyph = &font->data[index * font->fontHeight];
+
+	memset(cols, 0, 16 * sizeof(uint32_t));
+
+	for (uint8_t i = 0; i < font->fontHeight; i++) {
+		uint16_t b = glyph[i];
+
+		for (uint8_t j = 0; b; j++) {
+			if (b & 0x8000) {
+				cols[j] |= (uint32_t)1 << i;
+			}
+			b <<= 1;
+		}
+	}
+}
+
+
+#if SSD1306_GLYPH_CACHE_SIZE > 0
+
+/**
+ * @brief Glyph cache entry. Data holds the glyph already shifted to its
+ *        vertical offset within the page, stored page after page with
+ *        fontWidth bytes each.
+ */
+typedef struct {
+	const FontDef_t *font; /*!< Font of the cached glyph, NULL if unused. */
+	int16_t         index; /*!< Index of the cached glyph in the font data. */
+	uint8_t         shift; /*!< Vertical offset within the page (y mod 8). */
+	uint32_t        used;  /*!< Value of the use counter on the last hit. */
+	uint8_t         data[SSD1306_GLYPH_CACHE_ENTRY_DATA];
+} SSD1306_glyphCacheEntry_t;
+
+#define SSD1306_GLYPH_CACHE_ENTRIES \
+	(SSD1306_GLYPH_CACHE_SIZE / sizeof(SSD1306_glyphCacheEntry_t))
+
+_Static_assert(SSD1306_GLYPH_CACHE_ENTRIES >= 1,
+	"SSD1306_GLYPH_CACHE_SIZE is too small for a single glyph cache entry");
+
+/**
+ * @brief Private glyph cache, replaced in least recently used order.
+ */
+static SSD1306_glyphCacheEntry_t SSD1306_GlyphCache[SSD1306_GLYPH_CACHE_ENTRIES];
+
+/**
+ * @brief Private glyph cache counters.
+ */
+static SSD1306_glyphCacheStats_t SSD1306_GlyphCacheStats;
+
+
+/**
+ * @brief Returns the cache entry of the given glyph, rendering it into the
+ *        least recently used entry on a miss.
+ */
+static SSD1306_glyphCacheEntry_t *SSD1306_cacheGlyph(int16_t index,
+	FontDef_t *font, uint8_t shift) {
+
+	SSD1306_glyphCacheEntry_t *victim = &SSD1306_GlyphCache[0];
+	uint32_t now = ++SSD1306_GlyphCacheStats.accesses;
+
+	for (uint16_t k = 0; k < SSD1306_GLYPH_CACHE_ENTRIES; k++) {
+		SSD1306_glyphCacheEntry_t *e = &SSD1306_GlyphCache[k];
+
+		if (e->font == font && e->index == index && e->shift == shift) {
+			SSD1306_GlyphCacheStats.hits++;
+			e->used = now;
+			return e;
+		}
+
+		if (e->used < victim->used) {
+			victim = e;
+		}
+	}
+
+	SSD1306_GlyphCacheStats.misses++;
+
+	uint32_t cols[16];
+	uint8_t pages = (shift + font->fontHeight + 7) >> 3;
+
+	SSD1306_decodeGlyph(index, font, cols);
+
+	for (uint8_t j = 0; j < font->fontWidth; j++) {
+		uint64_t v = (uint64_t)cols[j] << shift;
+
+		for (uint8_t p = 0; p < pages; p++) {
+			victim->data[p * font->fontWidth + j] = (uint8_t)(v >> (p * 8));
+		}
+	}
+
+	victim->font = font;
+	victim->index = index;
+	victim->shift = shift;
+	victim->used = now;
+
+	return victim;
+}
+
+#endif
+
+
+/**
+ * @brief Renders a glyph at the given location. When the glyph cache is
+ *        enabled, the pre-rendered page bytes are masked into the buffer,
+ *        otherwise the glyph is decoded and written column by column.
+ */
+static void SSD1306_renderGlyph(uint16_t x, uint16_t y, int16_t index,
+	FontDef_t *font, SSD1306_color_t color, SSD1306_textMode_t mode) {
+
+#if SSD1306_GLYPH_CACHE_SIZE > 0
+	uint8_t shift = y & 0x07;
+	SSD1306_glyphCacheEntry_t *e = SSD1306_cacheGlyph(index, font, shift);
+	uint64_t mask = ((((uint64_t)1) << font->fontHeight) - 1) << shift;
+	const uint8_t *src = e->data;
+
+	for (uint8_t page = y >> 3; page < SSD1306_HEIGHT / 8 && mask; page++) {
+		uint8_t *dst = SSD1306_page(page);
+		uint8_t m = (uint8_t)mask & SSD1306_pageClip(page);
+
+		if (dst != NULL && m) {
+			for (uint8_t j = 0; j < font->fontWidth; j++) {
+				int16_t cx = x + j;
+
+				if (cx >= SSD1306_Clip.x0 && cx <= SSD1306_Clip.x1) {
+					SSD1306_writeByte(&dst[cx], m, src[j] & m, color, mode);
+				}
+			}
+		}
+
+		src += font->fontWidth;
+		mask >>= 8;
+	}
+#else
+	uint32_t cols[16];
+
+	SSD1306_decodeGlyph(index, font, cols);
+
+	for (uint8_t j = 0; j < font->fontWidth; j++) {
+		SSD1306_writeColumn(x + j, y, cols[j], font->fontHeight, color, mode);
+	}
+#endif
+}
+
+
+/**
+ * @brief Bit repetition tables of scaled text: entry n holds the 4 bits of n,
+ *        bit 0 first, each repeated 2, 3 or 4 times.
+ */
+static const uint16_t SSD1306_ScaleTable[3][16] = {
+	{ 0x0000, 0x0003, 0x000C, 0x000F, 0x0030, 0x0033, 0x003C, 0x003F,
+	  0x00C0, 0x00C3, 0x00CC, 0x00CF, 0x00F0, 0x00F3, 0x00FC, 0x00FF },
+	{ 0x0000, 0x0007, 0x0038, 0x003F, 0x01C0, 0x01C7, 0x01F8, 0x01FF,
+	  0x0E00, 0x0E07, 0x0E38, 0x0E3F, 0x0FC0, 0x0FC7, 0x0FF8, 0x0FFF },
+	{ 0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+	  0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF }
+};
+
+
+/**
+ * @brief Expands a column of height bits by the given scale, 4 bits at a
+ *        time, into page bytes starting shift bits into the first byte.
+ */
+static void SSD1306_expandColumn(uint32_t bits, uint8_t height, uint8_t scale,
+	uint8_t shift, uint8_t *out) {
+
+	const uint16_t *table = SSD1306_ScaleTable[scale - 2];
+	uint32_t acc = 0;
+	uint8_t n = shift;
+
+	for (uint8_t i = 0; i < height; i += 4) {
+		acc |= (uint32_t)table[(bits >> i) & 0x0F] << n;
+		n += 4 * scale;
+
+		while (n >= 8) {
+			*out++ = (uint8_t)acc;
+			acc >>= 8;
+			n -= 8;
+		}
+	}
+
+	if (n) {
+		*out = (uint8_t)acc;
+	}
+}
+
+
+/**
+ * @brief Renders a glyph enlarged by scale at the given location. Each
+ *        expanded column is written into scale buffer columns.
+ */
+static void SSD1306_renderGlyphScaled(uint16_t x, uint16_t y, int16_t index,
+	FontDef_t *font, uint8_t scale, SSD1306_color_t color,
+	SSD1306_textMode_t mode) {
+
+	// Up to 32 rows by 4 plus the shift and the last rounded up nibble.
+	uint8_t mask[18], data[18];
+	uint32_t cols[16];
+	uint8_t shift = y & 0x07;
+	uint8_t pages = (shift + font->fontHeight * scale + 7) >> 3;
+
+	SSD1306_decodeGlyph(index, font, cols);
+	SSD1306_expandColumn(((uint32_t)1 << font->fontHeight) - 1,
+		font->fontHeight, scale, shift, mask);
+
+	for (uint8_t j = 0; j < font->fontWidth; j++) {
+		SSD1306_expandColumn(cols[j], font->fontHeight, scale, shift, data);
+
+		for (uint8_t k = 0; k < pages; k++) {
+			uint8_t page = (y >> 3) + k;
+
+			if (page >= SSD1306_HEIGHT / 8) {
+				break;
+			}
+
+			uint8_t *dst = SSD1306_page(page);
+			uint8_t m = mask[k] & SSD1306_pageClip(page);
+
+			if (dst == NULL || !m) {
+				continue;
+			}
+
+			for (uint8_t r = 0; r < scale; r++) {
+				int16_t cx = x + j * scale + r;
+
+				if (cx >= SSD1306_Clip.x0 && cx <= SSD1306_Clip.x1) {
+					SSD1306_writeByte(&dst[cx], m, data[k] & m, color, mode);
+				}
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief Returns the bits of v in reverse order.
+ */
+static uint32_t SSD1306_reverseBits(uint32_t v) {
+	v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
+	v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
+	v = ((v >> 4) & 0x0F0F0F0F) | ((v & 0x0F0F0F0F) << 4);
+	v = ((v >> 8) & 0x00FF00FF) | ((v & 0x00FF00FF) << 8);
+
+	return (v >> 16) | (v << 16);
+}
+
+
+/**
+ * @brief Renders a glyph rotated clockwise, with the top left corner of the
+ *        rotated glyph at the given location. At 90 and 270 degrees each font
+ *        row is already a vertical run of pixels, so it is written as one
+ *        buffer column without decoding the glyph.
+ */
+static void SSD1306_renderGlyphRotated(uint16_t x, uint16_t y, int16_t index,
+	FontDef_t *font, SSD1306_rotation_t rotation, SSD1306_color_t color,
+	SSD1306_textMode_t mode) {
+
+	const uint16_t *rows = &font->data[index * font->fontHeight];
+	uint8_t w = font->fontWidth;
+	uint8_t h = font->fontHeight;
+
+	switch (rotation) {
+		case SSD1306_ROTATION_90:
+			// The top row ends up on the right, its first column on top.
+			for (uint8_t i = 0; i < h; i++) {
+				SSD1306_writeColumn(x + h - 1 - i, y,
+					SSD1306_reverseBits(rows[i]) >> 16, w, color, mode);
+			}
+			break;
+		case SSD1306_ROTATION_270:
+			// The top row ends up on the left, its first column at the bottom.
+			for (uint8_t i = 0; i < h; i++) {
+				SSD1306_writeColumn(x + i, y, rows[i] >> (16 - w), w, color,
+					mode);
+			}
+			break;
+		case SSD1306_ROTATION_180: {
+			uint32_t cols[16];
+
+			// Columns are written right to left, each one upside down.
+			SSD1306_decodeGlyph(index, font, cols);
+
+			for (uint8_t j = 0; j < w; j++) {
+				SSD1306_writeColumn(x + w - 1 - j, y,
+					SSD1306_reverseBits(cols[j]) >> (32 - h), h, color, mode);
+			}
+			break;
+		}
+		default:
+			SSD1306_renderGlyph(x, y, index, font, color, mode);
+			break;
+	}
+}
+
+
+/**
+ * @brief Streaming reader of @ref SSD1306_image_t data.
+ */
+typedef struct {
+	const uint8_t *src;        /*!< Next data byte. */
+	uint8_t       compressed;  /*!< Data is RLE compressed. */
+	uint8_t       count;       /*!< Bytes left in the current run. */
+	uint8_t       repeat;      /*!< The current run repeats *src. */
+} SSD1306_imageReader_t;
+
+
+/**
+ * @brief Returns the next decoded byte of an image.
+ */
+static inline uint8_t SSD1306_readImage(SSD1306_imageReader_t *r) {
+	if (!r->compressed) {
+		return *r->src++;
+	}
+
+	if (r->count == 0) {
+		uint8_t c = *r->src++;
+
+		r->repeat = c & 0x80;
+		r->count = r->repeat ? c - 0x7E : c + 1;
+	}
+
+	// The repeated byte is consumed with the last copy.
+	if (--r->count && r->repeat) {
+		return *r->src;
+	}
+
+	return *r->src++;
+}
+
+
+/**
+ * @brief Formats a number right-aligned into the first width characters of
+ *        out. Digits are computed from the least significant one and written
+ *        straight into their final position, so no reversal is needed. The
+ *        sign is only printed in base 10 and decimals > 0 inserts a decimal
+ *        point before the last decimals digits. The output is not
+ *        terminated.
+ * @retval Number of characters used by the number itself (excluding the
+ *         padding), or 0 if it does not fit the given width.
+ */
+static uint8_t SSD1306_formatNum(char *out, uint8_t width, int32_t num,
+	uint8_t base, uint8_t decimals, char pad) {
+
+	// Negating as unsigned also handles INT32_MIN.
+	uint32_t mag = (num < 0) ? (0u - (uint32_t)num) : (uint32_t)num;
+	uint8_t is_negative = (num < 0 && base == 10);
+	uint8_t pos = width;
+	uint8_t d = 0;
+
+	do {
+		if (decimals && d == decimals) {
+			if (pos == 0) {
+				return 0;
+			}
+			out[--pos] = '.';
+		}
+
+		if (pos == 0) {
+			return 0;
+		}
+
+		uint32_t rem = mag % base;
+		out[--pos] = (rem > 9) ? (rem - 10) + 'A' : rem + '0';
+		mag /= base;
+		d++;
+	} while (mag || d <= decimals);
+
+	if (pad == '0') {
+		while (pos > is_negative) {
+			out[--pos] = '0';
+		}
+	}
+
+	if (is_negative) {
+		if (pos == 0) {
+			return 0;
+		}
+		out[--pos] = '-';
+	}
+
+	uint8_t len = width - pos;
+
+	while (pos > 0) {
+		out[--pos] = pad;
+	}
+
+	return len;
+}
+
+
+/**
+ * @brief Computes the bounds of segments a to g and of the decimal point of a
+ *        seven-segment display digit, relative to the top left corner of the
+ *        digit: x0, y0, x1, y1.
+ */
+static void SSD1306_segBoxes(const SSD1306_segDisplay_t *disp,
+	int16_t box[8][4]) {
+
+	int16_t t = disp->thickness;
+	int16_t w = disp->digitW;
+	int16_t h = disp->digitH;
+
+	// Top of the middle segment.
+	int16_t mid = (h - t) / 2;
+
+	const int16_t boxes[8][4] = {
+		{ t, 0, w - t - 1, t - 1 },
+		{ w - t, t, w - 1, mid - 1 },
+		{ w - t, mid + t, w - 1, h - t - 1 },
+		{ t, h - t, w - t - 1, h - 1 },
+		{ 0, mid + t, t - 1, h - t - 1 },
+		{ 0, t, t - 1, mid - 1 },
+		{ t, mid, w - t - 1, mid + t - 1 },
+		{ w + 1, h - t, w + t, h - 1 }
+	};
+
+	memcpy(box, boxes, sizeof(boxes));
+}
+
+
+/**
+ * @brief Returns the left X location of a seven-segment display digit.
+ */
+static int16_t SSD1306_segDigitX(const SSD1306_segDisplay_t *disp,
+	uint8_t i) {
+
+	return disp->x + i * (disp->digitW + disp->thickness + 2);
+}
+
+
+#if SSD1306_PORTRAIT
+
+/**
+ * @brief Transposes an 8x8 pixel block: bit j of src[i] becomes bit i of
+ *        dst[j]. The block is handled as two 32-bit halves, swapping 1x1,
+ *        2x2 and then 4x4 sub-blocks.
+ */
+static void SSD1306_transpose8(const uint8_t *src, uint8_t *dst) {
+	uint32_t x = src[0] | (src[1] << 8) | ((uint32_t)src[2] << 16) |
+		((uint32_t)src[3] << 24);
+	uint32_t y = src[4] | (src[5] << 8) | ((uint32_t)src[6] << 16) |
+		((uint32_t)src[7] << 24);
+	uint32_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA;
+	x = x ^ t ^ (t << 7);
+	t = (y ^ (y >> 7)) & 0x00AA00AA;
+	y = y ^ t ^ (t << 7);
+
+	t = (x ^ (x >> 14)) & 0x0000CCCC;
+	x = x ^ t ^ (t << 14);
+	t = (y ^ (y >> 14)) & 0x0000CCCC;
+	y = y ^ t ^ (t << 14);
+
+	t = (x & 0x0F0F0F0F) | ((y << 4) & 0xF0F0F0F0);
+	y = (y & 0xF0F0F0F0) | ((x >> 4) & 0x0F0F0F0F);
+	x = t;
+
+	dst[0] = x;
+	dst[1] = x >> 8;
+	dst[2] = x >> 16;
+	dst[3] = x >> 24;
+	dst[4] = y;
+	dst[5] = y >> 8;
+	dst[6] = y >> 16;
+	dst[7] = y >> 24;
+}
+
+#endif
+
+
+#if !SSD1306_BAND_RENDERING
+
+/**
+ * @brief Returns a pointer to the given LCD RAM page as it must be sent,
+ *        valid at least from column start to column end. In portrait
+ *        orientation the page is built by transposing the driver buffer:
+ *        LCD RAM page p holds drawing area columns 8p to 8p+7.
+ */
+static const uint8_t *SSD1306_lcdPage(uint8_t page, int16_t start,
+	int16_t end) {
+
+#if SSD1306_PORTRAIT
+	for (int16_t q = start >> 3; q <= end >> 3; q++) {
+		SSD1306_transpose8(&SSD1306_Buffer[SSD1306_WIDTH * q + 8 * page],
+			&SSD1306_LcdPage[8 * q]);
+	}
+
+	return SSD1306_LcdPage;
+#else
+	(void)start;
+	(void)end;
+
+	return &SSD1306_Buffer[SSD1306_WIDTH * page];
+#endif
+}
+
+
+/**
+ * @brief Returns a single byte of the LCD RAM as it must be sent.
+ */
+static inline uint8_t SSD1306_lcdByte(uint8_t page, int16_t col) {
+#if SSD1306_PORTRAIT
+	const uint8_t *src = &SSD1306_Buffer[SSD1306_WIDTH * (col >> 3) + 8 * page];
+	uint8_t bit = col & 0x07;
+	uint8_t data = 0;
+
+	for (uint8_t i = 0; i < 8; i++) {
+		data |= ((src[i] >> bit) & 0x01) << i;
+	}
+
+	return data;
+#else
+	return SSD1306_Buffer[SSD1306_WIDTH * page + col];
+#endif
+}
+
+
+/**
+ * @brief Finds the next run of bytes to be sent in a page, starting from
+ *        column x. Without the shadow the run is the rest of the page. With
+ *        the shadow, it starts at the first byte that differs from the LCD
+ *        content and unchanged gaps are included as long as they are cheaper
+ *        than addressing a new run, which costs SSD1306_RUN_SETUP_BYTES. If
+ *        the shadow is not valid, every byte is considered changed.
+ * @retval 1 if a run has been found, 0 if the rest of the page is up to date.
+ */
+static uint8_t SSD1306_nextRun(uint8_t page, int16_t x, int16_t *start,
+	int16_t *end) {
+
+#if SSD1306_SHADOW_FLUSH
+	const uint8_t *cur;
+	uint8_t *old = &SSD1306_Shadow[SSD1306_LCD_WIDTH * page];
+	int16_t gap = 0;
+
+	if (x >= SSD1306_LCD_WIDTH) {
+		return 0;
+	}
+
+	cur = SSD1306_lcdPage(page, x, SSD1306_LCD_WIDTH - 1);
+
+	while (x < SSD1306_LCD_WIDTH && SSD1306_ShadowValid && cur[x] == old[x]) {
+		x++;
+	}
+
+	if (x >= SSD1306_LCD_WIDTH) {
+		return 0;
+	}
+
+	// Extends the run until the unchanged gap gets too long.
+	*start = *end = x;
+
+	for (x = x + 1; x < SSD1306_LCD_WIDTH; x++) {
+		if (!SSD1306_ShadowValid || cur[x] != old[x]) {
+			*end = x;
+			gap = 0;
+		} else if (++gap > SSD1306_RUN_SETUP_BYTES) {
+			break;
+		}
+	}
+#else
+	(void)page;
+
+	if (x >= SSD1306_LCD_WIDTH) {
+		return 0;
+	}
+
+	*start = x;
+	*end = SSD1306_LCD_WIDTH - 1;
+#endif
+
+	return 1;
+}
+
+#endif
+
+
+#if SSD1306_REGION_LOCKS
+
+/**
+ * @brief Returns the lock bits of a range of pages.
+ */
+static inline unsigned int SSD1306_pageMask(uint8_t first, uint8_t last) {
+	return (2u << last) - (1u << first);
+}
+
+
+/**
+ * @brief Locks all the given pages at once, or none of them.
+ * @retval 1 if the pages have been locked, 0 if any of them is already locked.
+ */
+static uint8_t SSD1306_tryLockPages(unsigned int mask) {
+	unsigned int locks = atomic_load_explicit(&SSD1306_PageLocks,
+		memory_order_relaxed);
+
+	do {
+		if (locks & mask) {
+			return 0;
+		}
+	} while (!atomic_compare_exchange_weak_explicit(&SSD1306_PageLocks, &locks,
+		locks | mask, memory_order_acquire, memory_order_relaxed));
+
+	return 1;
+}
+
+
+/**
+ * @brief Locks the given pages, waiting until none of them is locked.
+ */
+static void SSD1306_lockPages(unsigned int mask) {
+	while (!SSD1306_tryLockPages(mask)) {
+		SSD1306_LOCK_WAIT();
+	}
+}
+
+
+/**
+ * @brief Unlocks the given pages.
+ */
+static void SSD1306_unlockPages(unsigned int mask) {
+	atomic_fetch_and_explicit(&SSD1306_PageLocks, ~mask, memory_order_release);
+}
+
+#endif
+
+
+#if !SSD1306_BAND_RENDERING
+
+/**
+ * @brief Sends the given columns of a page: the page and column addresses
+ *        in a single command transaction, followed by the data. The shadow
+ *        is updated only once the data has been sent, and invalidated if a
+ *        transfer fails since the LCD content is unknown from then on.
+ */
+static SSD1306_status_t SSD1306_sendRun(uint8_t page, int16_t start,
+	int16_t end) {
+
+	uint8_t cmd[3] = { 0xB0 + page, start & 0x0F, 0x10 | (start >> 4) };
+	uint16_t len = end - start + 1;
+	const uint8_t *src = SSD1306_lcdPage(page, start, end) + start;
+
+	SSD1306_status_t status = SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00,
+		cmd, sizeof(cmd));
+
+	if (status == LCD_OK) {
+		status = SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x40, (uint8_t *)src,
+			len);
+	}
+
+	if (status != LCD_OK) {
+		SSD1306_SHADOW_INVALIDATE();
+		return status;
+	}
+
+#if SSD1306_SHADOW_FLUSH
+	memcpy(&SSD1306_Shadow[SSD1306_LCD_WIDTH * page + start], src, len);
+
+	SSD1306_FlushStats.bytesSent += SSD1306_RUN_SETUP_BYTES + len;
+	SSD1306_FlushStats.lastBytesSent += SSD1306_RUN_SETUP_BYTES + len;
+#endif
+
+	return LCD_OK;
+}
+
+
+/**
+ * @brief Sends the given columns of a range of pages as a single strip. The
+ *        LCD is switched to vertical addressing with a window on the strip,
+ *        so the buffer bytes are gathered column by column straight into the
+ *        transmit buffer and sent without any further addressing, then page
+ *        addressing is restored, even after a failed transfer. The shadow is
+ *        handled as in SSD1306_sendRun.
+ */
+static SSD1306_status_t SSD1306_sendStrip(int16_t start, int16_t end,
+	uint8_t start_page, uint8_t end_page) {
+
+	uint8_t cmd[8] = { 0x20, 0x01, 0x21, start, end, 0x22, start_page,
+		end_page };
+	uint8_t page = start_page;
+	int16_t x = start;
+	uint16_t n = 1;
+
+	SSD1306_status_t status = SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00,
+		cmd, sizeof(cmd));
+
+	// The LCD address pointer moves down the pages first, then to the next
+	// column, so it keeps going across transactions if the strip is split.
+	data_tmp[0] = 0x40;
+
+	while (x <= end && status == LCD_OK) {
+		data_tmp[n++] = SSD1306_lcdByte(page, x);
+
+		if (page++ == end_page) {
+			page = start_page;
+			x++;
+		}
+
+		if (n == SSD1306_I2C_DATATMP_SIZE || x > end) {
+			if (HAL_I2C_Master_Transmit(SSD1306.i2c_ptr, SSD1306_I2C_ADDR,
+				data_tmp, n, SSD1306_I2C_TIMEOUT) != HAL_OK) {
+
+				status = I2C_ERROR;
+			}
+
+			n = 1;
+		}
+	}
+
+	cmd[1] = 0x02;
+
+	SSD1306_status_t restore = SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00,
+		cmd, 2);
+
+	if (status == LCD_OK) {
+		status = restore;
+	}
+
+	if (status != LCD_OK) {
+		SSD1306_SHADOW_INVALIDATE();
+		return status;
+	}
+
+#if SSD1306_SHADOW_FLUSH
+	for (page = start_page; page <= end_page; page++) {
+		memcpy(&SSD1306_Shadow[SSD1306_LCD_WIDTH * page + start],
+			SSD1306_lcdPage(page, start, end) + start, end - start + 1);
+	}
+
+	uint32_t sent = SSD1306_STRIP_SETUP_BYTES +
+		(end - start + 1) * (end_page - start_page + 1);
+
+	SSD1306_FlushStats.bytesSent += sent;
+	SSD1306_FlushStats.lastBytesSent += sent;
+#endif
+
+	return LCD_OK;
+}
+
+
+/**
+ * @brief Bookkeeping done when a whole frame has been flushed.
+ */
+static void SSD1306_endFlush(void) {
+#if SSD1306_SHADOW_FLUSH
+	SSD1306_ShadowValid = 1;
+
+	SSD1306_FlushStats.flushes++;
+	SSD1306_FlushStats.bytesAvoided +=
+		SSD1306_FULL_FLUSH_BYTES - SSD1306_FlushStats.lastBytesSent;
+#endif
+}
+
+
+/**
+ * @brief Bookkeeping done when a frame flush starts.
+ */
+static void SSD1306_startFlush(void) {
+#if SSD1306_SHADOW_FLUSH
+	SSD1306_FlushStats.lastBytesSent = 0;
+#endif
+}
+
+#endif
+
+
+/**
+ * @brief Resets the LCD structure, checks that the LCD answers and sends the
+ *        initialization table in a single transaction. A warm start checks
+ *        the LCD only once, does not turn the display off meanwhile and
+ *        leaves the contrast as it is.
+ */
+static SSD1306_status_t SSD1306_configure(I2C_HandleTypeDef *i2c_ptr,
+	uint8_t warm, SSD1306_rotation_t rotation, uint8_t is_inverted) {
+
+	uint8_t cmds[sizeof(SSD1306_InitCmds)];
+	uint8_t len = sizeof(cmds);
+
+#if SSD1306_EXTERNAL_MEMORY
+	if (SSD1306_Buffer == NULL) {
+		return INVALID_PARAMS;
+	}
+#endif
+
+	// Saves the used i2c peripheral and keeps track of it.
+	SSD1306.i2c_ptr = i2c_ptr;
+
+	// Resets the LCD structure.
+	SSD1306.currentX = 0;
+	SSD1306.currentY = 0;
+	SSD1306.hwInverted = (is_inverted != 0);
+	SSD1306.contrast = 0xFF;
+	SSD1306.rotation = rotation;
+	SSD1306.initialized = 0;
+
+	// The LCD RAM content is unknown after a power cycle, and the remap set
+	// again below only applies to data written afterwards.
+	SSD1306_SHADOW_INVALIDATE();
+
+	if (HAL_I2C_IsDeviceReady(SSD1306.i2c_ptr, SSD1306_I2C_ADDR,
+		warm ? 1 : 10, warm ? SSD1306_I2C_WARM_TIMEOUT : SSD1306_I2C_TIMEOUT)
+		!= HAL_OK) {
+
+		return I2C_ERROR;
+	}
+
+	if (!warm) {
+		HAL_Delay(10);
+	}
+
+	memcpy(cmds, SSD1306_InitCmds, sizeof(cmds));
+	cmds[SSD1306_INIT_COM_SCAN] = SSD1306_RotationCmds[SSD1306.rotation][1];
+	cmds[SSD1306_INIT_SEG_REMAP] = SSD1306_RotationCmds[SSD1306.rotation][0];
+	cmds[SSD1306_INIT_INVERT] = SSD1306.hwInverted ? SSD1306_INVERTDISPLAY :
+		SSD1306_NORMALDISPLAY;
+
+	if (!warm) {
+		return SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00, cmds, len);
+	}
+
+	// Drops the contrast command, then the first command, which turns the
+	// display off.
+	memmove(&cmds[SSD1306_INIT_CONTRAST], &cmds[SSD1306_INIT_CONTRAST + 2],
+		len - SSD1306_INIT_CONTRAST - 2);
+	len -= 2;
+
+	return SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00, cmds + 1, len - 1);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS.
+///////////////////////////////////////////////////////////////////////////////
+
+SSD1306_status_t SSD1306_init(I2C_HandleTypeDef *i2c_ptr) {
+	SSD1306_status_t status = SSD1306_configure(i2c_ptr, 0,
+		SSD1306_PORTRAIT ? SSD1306_ROTATION_90 : SSD1306_ROTATION_0, 0);
+
+	if (status != LCD_OK) {
+		return status;
+	}
+
+	SSD1306.initialized = 1;
+
+	return SSD1306_clear();
+}
+
+
+SSD1306_status_t SSD1306_initWarm(I2C_HandleTypeDef *i2c_ptr,
+	SSD1306_rotation_t rotation, uint8_t is_inverted) {
+
+	// The drawing area cannot be transposed at runtime.
+	if (rotation > SSD1306_ROTATION_270 ||
+		(rotation & 0x01) != SSD1306_PORTRAIT) {
+
+		return INVALID_PARAMS;
+	}
+
+	SSD1306_status_t status = SSD1306_configure(i2c_ptr, 1, rotation,
+		is_inverted);
+
+	if (status != LCD_OK) {
+		return status;
+	}
+
+	SSD1306.initialized = 1;
+
+	return LCD_OK;
+}
+
+
+#if SSD1306_EXTERNAL_MEMORY
+
+SSD1306_status_t SSD1306_setMemory(uint8_t *buffer, uint8_t *xfer) {
+	if (buffer == NULL || ((uintptr_t)buffer % SSD1306_MEMORY_ALIGN) != 0) {
+		return INVALID_PARAMS;
+	}
+
+	if (xfer == NULL) {
+		xfer = buffer + SSD1306_XFER_MEMORY_OFFSET;
+	}
+
+	if (((uintptr_t)xfer % SSD1306_MEMORY_ALIGN) != 0) {
+		return INVALID_PARAMS;
+	}
+
+#if SSD1306_BAND_RENDERING
+	SSD1306_Band = buffer;
+	SSD1306_Band[0] = 0x40;
+	SSD1306_Buffer = buffer + 1;
+#else
+	SSD1306_Buffer = buffer;
+#endif
+	data_tmp = xfer;
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_initWithMemory(I2C_HandleTypeDef *i2c_ptr,
+	uint8_t *buffer, uint8_t *xfer) {
+
+	SSD1306_status_t status = SSD1306_setMemory(buffer, xfer);
+
+	if (status != LCD_OK) {
+		return status;
+	}
+
+	return SSD1306_init(i2c_ptr);
+}
+
+#endif
+
+
+SSD1306_status_t SSD1306_clear(void) {
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+#if SSD1306_BAND_RENDERING
+	return SSD1306_renderBands(NULL, NULL);
+#else
+	SSD1306_fill(SSD1306_COLOR_BLACK);
+	SSD1306_updateScreen();
+
+	return LCD_OK;
+#endif
+}
+
+
+SSD1306_status_t SSD1306_invertDisplay(uint8_t is_inverted) {
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+	if (is_inverted)
+		SSD1306_WRITECOMMAND(SSD1306_INVERTDISPLAY);
+	else
+		SSD1306_WRITECOMMAND(SSD1306_NORMALDISPLAY);
+
+	SSD1306.hwInverted = (is_inverted != 0);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_setRotation(SSD1306_rotation_t rotation) {
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+	// The drawing area cannot be transposed at runtime.
+	if (rotation > SSD1306_ROTATION_270 ||
+		(rotation & 0x01) != SSD1306_PORTRAIT) {
+
+		return INVALID_PARAMS;
+	}
+
+	SSD1306_status_t status = SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00,
+		(uint8_t *)SSD1306_RotationCmds[rotation], 2);
+
+	if (status != LCD_OK) {
+		return status;
+	}
+
+	SSD1306.rotation = rotation;
+	SSD1306_SHADOW_INVALIDATE();
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_updateScreen(void) {
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+#if SSD1306_BAND_RENDERING
+	// There is no full frame to send: see SSD1306_renderBands.
+	return INVALID_PARAMS;
+#else
+	// Any incremental flush in progress is superseded.
+	SSD1306_Flush.active = 0;
+	SSD1306_startFlush();
+
+	for (uint8_t m = 0; m < SSD1306_MAX_PAGE_NUM; m++) {
+		int16_t start, end, x = 0;
+
+		SSD1306_LOCK_PAGES(m, m);
+
+		while (SSD1306_nextRun(m, x, &start, &end)) {
+			SSD1306_status_t status = SSD1306_sendRun(m, start, end);
+
+			if (status != LCD_OK) {
+				SSD1306_UNLOCK_PAGES(m, m);
+				return status;
+			}
+
+			x = end + 1;
+		}
+
+		SSD1306_UNLOCK_PAGES(m, m);
+	}
+
+	SSD1306_endFlush();
+
+	return LCD_OK;
+#endif
+}
+
+
+SSD1306_status_t SSD1306_updateScreenStep(uint8_t *done) {
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+#if SSD1306_BAND_RENDERING
+	// There is no full frame to send: see SSD1306_renderBands.
+	(void)done;
+	return INVALID_PARAMS;
+#else
+	int16_t start, end;
+
+	if (done == NULL) {
+		return INVALID_PARAMS;
+	}
+
+	if (!SSD1306_Flush.active) {
+		SSD1306_Flush.active = 1;
+		SSD1306_Flush.page = 0;
+		SSD1306_Flush.col = 0;
+		SSD1306_startFlush();
+	}
+
+	// Sends the next run, at most SSD1306_FLUSH_CHUNK_SIZE bytes of it.
+	while (SSD1306_Flush.page < SSD1306_MAX_PAGE_NUM) {
+		SSD1306_LOCK_PAGES(SSD1306_Flush.page, SSD1306_Flush.page);
+
+		if (SSD1306_nextRun(SSD1306_Flush.page, SSD1306_Flush.col, &start,
+			&end)) {
+
+			if (end - start >= SSD1306_FLUSH_CHUNK_SIZE) {
+				end = start + SSD1306_FLUSH_CHUNK_SIZE - 1;
+			}
+
+			SSD1306_status_t status = SSD1306_sendRun(SSD1306_Flush.page,
+				start, end);
+
+			SSD1306_UNLOCK_PAGES(SSD1306_Flush.page, SSD1306_Flush.page);
+
+			// The next call starts a new flush from the first page.
+			if (status != LCD_OK) {
+				SSD1306_Flush.active = 0;
+				return status;
+			}
+
+			SSD1306_Flush.col = end + 1;
+			*done = 0;
+
+			return LCD_OK;
+		}
+
+		SSD1306_UNLOCK_PAGES(SSD1306_Flush.page, SSD1306_Flush.page);
+		SSD1306_Flush.page++;
+		SSD1306_Flush.col = 0;
+	}
+
+	SSD1306_Flush.active = 0;
+	SSD1306_endFlush();
+	*done = 1;
+
+	return LCD_OK;
+#endif
+}
+
+
+SSD1306_status_t SSD1306_updateArea(uint16_t x, uint16_t y, uint16_t w,
+	uint16_t h) {
+
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+#if SSD1306_BAND_RENDERING
+	// There is no full frame to send: see SSD1306_renderBands.
+	(void)x;
+	(void)y;
+	(void)w;
+	(void)h;
+	return INVALID_PARAMS;
+#else
+	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT || w == 0 || h == 0) {
+		return INVALID_PARAMS;
+	}
+
+	if ((x + w) > SSD1306_WIDTH) {
+		w = SSD1306_WIDTH - x;
+	}
+
+	if ((y + h) > SSD1306_HEIGHT) {
+		h = SSD1306_HEIGHT - y;
+	}
+
+	// Area in LCD RAM columns and pages.
+#if SSD1306_PORTRAIT
+	int16_t start = y, end = y + h - 1;
+	uint8_t start_page = x >> 3;
+	uint8_t end_page = (x + w - 1) >> 3;
+#else
+	int16_t start = x, end = x + w - 1;
+	uint8_t start_page = y >> 3;
+	uint8_t end_page = (y + h - 1) >> 3;
+#endif
+
+	SSD1306_status_t status = LCD_OK;
+
+	// Sends the columns of every page touched by the area, as one strip when
+	// addressing each page separately costs more.
+	if ((end_page - start_page + 1) * SSD1306_RUN_SETUP_BYTES >
+		SSD1306_STRIP_SETUP_BYTES) {
+
+		SSD1306_LOCK_PAGES(start_page, end_page);
+		status = SSD1306_sendStrip(start, end, start_page, end_page);
+		SSD1306_UNLOCK_PAGES(start_page, end_page);
+	} else {
+		for (uint8_t m = start_page; m <= end_page && status == LCD_OK; m++) {
+			SSD1306_LOCK_PAGES(m, m);
+			status = SSD1306_sendRun(m, start, end);
+			SSD1306_UNLOCK_PAGES(m, m);
+		}
+	}
+
+	return status;
+#endif
+}
+
+
+SSD1306_status_t SSD1306_updateColumns(uint16_t x, uint16_t w,
+	uint8_t start_page, uint8_t end_page) {
+
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+#if SSD1306_BAND_RENDERING
+	// There is no full frame to send: see SSD1306_renderBands.
+	(void)x;
+	(void)w;
+	(void)start_page;
+	(void)end_page;
+	return INVALID_PARAMS;
+#else
+	if (x >= SSD1306_LCD_WIDTH || w == 0 || start_page > end_page ||
+		end_page >= SSD1306_MAX_PAGE_NUM) {
+
+		return INVALID_PARAMS;
+	}
+
+	if ((x + w) > SSD1306_LCD_WIDTH) {
+		w = SSD1306_LCD_WIDTH - x;
+	}
+
+	SSD1306_LOCK_PAGES(start_page, end_page);
+	SSD1306_status_t status = SSD1306_sendStrip(x, x + w - 1, start_page,
+		end_page);
+	SSD1306_UNLOCK_PAGES(start_page, end_page);
+
+	return status;
+#endif
+}
+
+
+SSD1306_status_t SSD1306_toggleInvert(void) {
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+#if SSD1306_SOFTWARE_INVERT
+#if SSD1306_BAND_RENDERING
+	// Only one page is held in RAM: see SSD1306_invertDisplay.
+	return INVALID_PARAMS;
+#else
+	SSD1306_maskBytes(SSD1306_Buffer, SSD1306_BUFFER_SIZE, 0x00, 0x00, 0xFF);
+
+	// Updates internal status.
+	SSD1306.inverted = !SSD1306.inverted;
+
+	return LCD_OK;
+#endif
+#else
+	// The LCD inverts its output: the buffer and the colors are unchanged.
+	return SSD1306_invertDisplay(!SSD1306.hwInverted);
+#endif
+}
+
+
+SSD1306_status_t SSD1306_scrollRight(uint8_t start_page, uint8_t end_page) {
+	if (start_page >= SSD1306_MAX_PAGE_NUM ||
+		end_page >= SSD1306_MAX_PAGE_NUM) {
+
+		return INVALID_PARAMS;
+	}
+
+	if (start_page > end_page) {
+		return INVALID_PARAMS;
+	}
+
+	// Right horizontal scroll.
+	SSD1306_WRITECOMMAND(SSD1306_RIGHT_HORIZONTAL_SCROLL);
+	SSD1306_WRITECOMMAND(0x00);       // Dummy byte.
+	SSD1306_WRITECOMMAND(start_page); // Start page address.
+
+	// Time interval between each scroll step as 5 frames.
+	SSD1306_WRITECOMMAND(0X00);
+
+	SSD1306_WRITECOMMAND(end_page);   // End page address.
+	SSD1306_WRITECOMMAND(0X00);
+	SSD1306_WRITECOMMAND(0xFF);		  // Scroll offset for continuous movement.
+	SSD1306_WRITECOMMAND(SSD1306_ACTIVATE_SCROLL); // Start scrolling.
+	SSD1306_SHADOW_INVALIDATE();
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_scrollLeft(uint8_t start_page, uint8_t end_page) {
+	if (start_page >= SSD1306_MAX_PAGE_NUM ||
+		end_page >= SSD1306_MAX_PAGE_NUM) {
+
+		return INVALID_PARAMS;
+	}
+
+	if (start_page > end_page) {
+		return INVALID_PARAMS;
+	}
+
+	// Left horizontal scroll.
+	SSD1306_WRITECOMMAND(SSD1306_LEFT_HORIZONTAL_SCROLL);
+	SSD1306_WRITECOMMAND(0x00);  	  // Dummy byte.
+	SSD1306_WRITECOMMAND(start_page); // Start page address.
+
+	// Time interval between each scroll step as 5 frames.
+	SSD1306_WRITECOMMAND(0X00);
+
+	SSD1306_WRITECOMMAND(end_page);  // End page address.
+	SSD1306_WRITECOMMAND(0X00);
+	SSD1306_WRITECOMMAND(0XFF);
+	SSD1306_WRITECOMMAND(SSD1306_ACTIVATE_SCROLL); // Start scrolling.
+	SSD1306_SHADOW_INVALIDATE();
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_scrollDiagRight(uint8_t start_page, uint8_t end_page) {
+	if (start_page >= SSD1306_MAX_PAGE_NUM ||
+		end_page >= SSD1306_MAX_PAGE_NUM) {
+
+		return INVALID_PARAMS;
+	}
+
+	if (start_page > end_page) {
+		return INVALID_PARAMS;
+	}
+
+	SSD1306_WRITECOMMAND(SSD1306_SET_VERTICAL_SCROLL_AREA);
+	SSD1306_WRITECOMMAND(0x00); 					// Dummy byte.
+	SSD1306_WRITECOMMAND(SSD1306_LCD_HEIGHT);
+
+	SSD1306_WRITECOMMAND(SSD1306_VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL);
+	SSD1306_WRITECOMMAND(0x00);
+	SSD1306_WRITECOMMAND(start_page);				// Start page address.
+	SSD1306_WRITECOMMAND(0X00);
+	SSD1306_WRITECOMMAND(end_page);					// End page address.
+	SSD1306_WRITECOMMAND(0x01);
+	SSD1306_WRITECOMMAND(SSD1306_ACTIVATE_SCROLL);
+	SSD1306_SHADOW_INVALIDATE();
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_scrollDiagLeft(uint8_t start_page, uint8_t end_page) {
+	if (start_page >= SSD1306_MAX_PAGE_NUM ||
+		end_page >= SSD1306_MAX_PAGE_NUM) {
+
+		return INVALID_PARAMS;
+	}
+
+	if (start_page > end_page) {
+		return INVALID_PARAMS;
+	}
+
+	SSD1306_WRITECOMMAND(SSD1306_SET_VERTICAL_SCROLL_AREA);
+	SSD1306_WRITECOMMAND(0x00);						// Dummy byte.
+	SSD1306_WRITECOMMAND(SSD1306_LCD_HEIGHT);
+
+	SSD1306_WRITECOMMAND(SSD1306_VERTICAL_AND_LEFT_HORIZONTAL_SCROLL);
+	SSD1306_WRITECOMMAND(0x00);
+	SSD1306_WRITECOMMAND(start_page);				// Start page address.
+	SSD1306_WRITECOMMAND(0X00);
+    SSD1306_WRITECOMMAND(end_page);					// End page address.
+    SSD1306_WRITECOMMAND(0x01);
+    SSD1306_WRITECOMMAND(SSD1306_ACTIVATE_SCROLL);
+    SSD1306_SHADOW_INVALIDATE();
+
+    return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_stopScroll(void) {
+	SSD1306_WRITECOMMAND(SSD1306_DEACTIVATE_SCROLL);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_fadeOut(uint8_t interval) {
+	uint8_t cmd[2] = { SSD1306_SET_FADE_BLINK, 0x20 | interval };
+
+	if (interval > 0x0F) {
+		return INVALID_PARAMS;
+	}
+
+	return SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00, cmd, sizeof(cmd));
+}
+
+
+SSD1306_status_t SSD1306_blink(uint8_t interval) {
+	uint8_t cmd[2] = { SSD1306_SET_FADE_BLINK, 0x30 | interval };
+
+	if (interval > 0x0F) {
+		return INVALID_PARAMS;
+	}
+
+	return SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00, cmd, sizeof(cmd));
+}
+
+
+SSD1306_status_t SSD1306_stopFade(void) {
+	uint8_t cmd[2] = { SSD1306_SET_FADE_BLINK, 0x00 };
+
+	return SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00, cmd, sizeof(cmd));
+}
+
+
+SSD1306_status_t SSD1306_zoom(uint8_t enable) {
+	uint8_t cmd[2] = { SSD1306_SET_ZOOM, (enable != 0) };
+
+	return SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00, cmd, sizeof(cmd));
+}
+
+
+SSD1306_status_t SSD1306_setContrast(uint8_t contrast) {
+	uint8_t cmd[2] = { SSD1306_SET_CONTRAST, contrast };
+
+	SSD1306_status_t status =
+		SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00, cmd, sizeof(cmd));
+
+	if (status == LCD_OK) {
+		SSD1306.contrast = contrast;
+	}
+
+	return status;
+}
+
+
+SSD1306_status_t SSD1306_contrastStep(uint8_t target, uint8_t step,
+	uint8_t *done) {
+
+	uint8_t contrast = SSD1306.contrast;
+
+	if (done == NULL || step == 0) {
+		return INVALID_PARAMS;
+	}
+
+	if (contrast < target) {
+		contrast = (target - contrast > step) ? contrast + step : target;
+	} else if (contrast > target) {
+		contrast = (contrast - target > step) ? contrast - step : target;
+	}
+
+	if (contrast != SSD1306.contrast) {
+		SSD1306_setContrast(contrast);
+	}
+
+	*done = (contrast == target);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_fill(SSD1306_color_t color) {
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
+
+	// Whole bytes are written: the C library fill is the fastest there is.
+	switch (color) {
+		case SSD1306_COLOR_BLACK:
+			memset(SSD1306_Buffer, 0x00, SSD1306_BUFFER_SIZE);
+			break;
+		case SSD1306_COLOR_WHITE:
+			memset(SSD1306_Buffer, 0xFF, SSD1306_BUFFER_SIZE);
+			break;
+		default:
+			return INVALID_PARAMS;
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawPixel(uint16_t x, uint16_t y, SSD1306_color_t color) {
+	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+		return INVALID_PARAMS;
+	}
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	// Shifting right by 3 means dividing by 8. Pixels outside the clipping
+	// rectangle or of pages that are not being rendered are dropped.
+	uint8_t *dst = SSD1306_page(y >> 3);
+
+	if (dst == NULL || x < SSD1306_Clip.x0 || x > SSD1306_Clip.x1 ||
+		y < SSD1306_Clip.y0 || y > SSD1306_Clip.y1) {
+
+		return LCD_OK;
+	}
+
+	// Sets color. Bitwise ANDing by 0x7 means getting the remainder of a
+	// division by 8.
+	switch (color) {
+		case SSD1306_COLOR_WHITE:
+			dst[x] |= 1 << (y & 0x07);
+			break;
+		case SSD1306_COLOR_BLACK:
+			dst[x] &= ~(1 << (y & 0x07));
+			break;
+		default:
+			return INVALID_PARAMS;
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawBitmap(int16_t x, int16_t y,
+	const unsigned char* bitmap, int16_t w, int16_t h, SSD1306_color_t color) {
+
+    int16_t byteWidth = (w + 7) >> 3; // Bitmap scanline pad = whole byte
+    uint8_t byte = 0;
+
+    for(int16_t j=0; j<h; j++, y++) {
+        for(int16_t i=0; i<w; i++) {
+            if(i & 7) {
+               byte <<= 1;
+            }
+            else {
+               byte = (*(const unsigned char *)(&bitmap[j * byteWidth + i / 8]));
+            }
+            if(byte & 0x80) SSD1306_drawPixel(x+i, y, color);
+        }
+    }
+
+    return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_setClipRect(int16_t x, int16_t y, int16_t w,
+	int16_t h) {
+
+	if (w <= 0 || h <= 0) {
+		return INVALID_PARAMS;
+	}
+
+	// Keeps the rectangle inside the visible area.
+	SSD1306_Clip.x0 = (x < 0) ? 0 : x;
+	SSD1306_Clip.y0 = (y < 0) ? 0 : y;
+	SSD1306_Clip.x1 = (x + w > SSD1306_WIDTH) ? SSD1306_WIDTH - 1 : x + w - 1;
+	SSD1306_Clip.y1 = (y + h > SSD1306_HEIGHT) ? SSD1306_HEIGHT - 1 : y + h - 1;
+
+	if (SSD1306_Clip.x0 > SSD1306_Clip.x1 || SSD1306_Clip.y0 > SSD1306_Clip.y1) {
+		SSD1306_resetClipRect();
+		return INVALID_PARAMS;
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_resetClipRect(void) {
+	SSD1306_Clip.x0 = 0;
+	SSD1306_Clip.y0 = 0;
+	SSD1306_Clip.x1 = SSD1306_WIDTH - 1;
+	SSD1306_Clip.y1 = SSD1306_HEIGHT - 1;
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_gotoXY(uint16_t x, uint16_t y) {
+	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+		return INVALID_PARAMS;
+	}
+
+	// Sets write pointers.
+	SSD1306.currentX = x;
+	SSD1306.currentY = y;
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_putc(char ch, FontDef_t *font, SSD1306_color_t color) {
+	// Check available space on the visible LCD area.
+	if (SSD1306_WIDTH < (SSD1306.currentX + font->fontWidth) ||
+		SSD1306_HEIGHT < (SSD1306.currentY + font->fontHeight)) {
+
+		return INVALID_PARAMS;
+	}
+
+	// A single byte is taken as a Latin-1 code point.
+	int16_t index = get_glyph_index(font, (uint8_t)ch);
+
+	if (index < 0) {
+		return INVALID_PARAMS;
+	}
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	SSD1306_renderGlyph(SSD1306.currentX, SSD1306.currentY, index, font, color,
+		SSD1306_TEXT_OPAQUE);
+
+	// Updates the X pointer.
+	SSD1306.currentX += font->fontWidth;
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_puts(char* str, FontDef_t *font, SSD1306_color_t color) {
+	return SSD1306_putsMode(str, font, color, SSD1306_TEXT_OPAQUE);
+}
+
+
+SSD1306_status_t SSD1306_putsMode(char* str, FontDef_t *font,
+	SSD1306_color_t color, SSD1306_textMode_t mode) {
+
+	SSD1306_status_t status = LCD_OK;
+	const char *s = str;
+	uint16_t cp;
+
+	if (SSD1306.currentX >= SSD1306_WIDTH ||
+		SSD1306_HEIGHT < (SSD1306.currentY + font->fontHeight)) {
+
+		return INVALID_PARAMS;
+	}
+
+	// Computes once how many whole glyphs fit before the right edge.
+	uint16_t fit = (SSD1306_WIDTH - SSD1306.currentX) / font->fontWidth;
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	// The string is UTF-8 encoded: each code point takes one glyph.
+	while ((cp = get_code_point(&s)) != 0) {
+		if (fit == 0) {
+			status = INVALID_PARAMS;
+			break;
+		}
+
+		int16_t index = get_glyph_index(font, cp);
+
+		if (index < 0) {
+			status = INVALID_PARAMS;
+		} else {
+			SSD1306_renderGlyph(SSD1306.currentX, SSD1306.currentY, index,
+				font, color, mode);
+		}
+
+		// Updates the X pointer.
+		SSD1306.currentX += font->fontWidth;
+		fit--;
+	}
+
+	return status;
+}
+
+
+SSD1306_status_t SSD1306_putsScaled(char *str, FontDef_t *font, uint8_t scale,
+	SSD1306_color_t color, SSD1306_textMode_t mode) {
+
+	SSD1306_status_t status = LCD_OK;
+	const char *s = str;
+	uint16_t cp;
+
+	if (scale < 1 || scale > 4) {
+		return INVALID_PARAMS;
+	}
+
+	if (scale == 1) {
+		return SSD1306_putsMode(str, font, color, mode);
+	}
+
+	if (SSD1306.currentX >= SSD1306_WIDTH ||
+		SSD1306_HEIGHT < (SSD1306.currentY + font->fontHeight * scale)) {
+
+		return INVALID_PARAMS;
+	}
+
+	uint8_t cell = font->fontWidth * scale;
+	uint16_t fit = (SSD1306_WIDTH - SSD1306.currentX) / cell;
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	while ((cp = get_code_point(&s)) != 0) {
+		if (fit == 0) {
+			status = INVALID_PARAMS;
+			break;
+		}
+
+		int16_t index = get_glyph_index(font, cp);
+
+		if (index < 0) {
+			status = INVALID_PARAMS;
+		} else {
+			SSD1306_renderGlyphScaled(SSD1306.currentX, SSD1306.currentY,
+				index, font, scale, color, mode);
+		}
+
+		// Updates the X pointer.
+		SSD1306.currentX += cell;
+		fit--;
+	}
+
+	return status;
+}
+
+
+SSD1306_status_t SSD1306_putcRotated(char ch, FontDef_t *font,
+	SSD1306_rotation_t rotation, SSD1306_color_t color) {
+
+	uint8_t vertical = (rotation == SSD1306_ROTATION_90 ||
+		rotation == SSD1306_ROTATION_270);
+	uint8_t box_w = vertical ? font->fontHeight : font->fontWidth;
+	uint8_t box_h = vertical ? font->fontWidth : font->fontHeight;
+
+	// Check available space on the visible LCD area.
+	if (rotation > SSD1306_ROTATION_270 ||
+		SSD1306_WIDTH < (SSD1306.currentX + box_w) ||
+		SSD1306_HEIGHT < (SSD1306.currentY + box_h)) {
+
+		return INVALID_PARAMS;
+	}
+
+	// A single byte is taken as a Latin-1 code point.
+	int16_t index = get_glyph_index(font, (uint8_t)ch);
+
+	if (index < 0) {
+		return INVALID_PARAMS;
+	}
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	SSD1306_renderGlyphRotated(SSD1306.currentX, SSD1306.currentY, index,
+		font, rotation, color, SSD1306_TEXT_OPAQUE);
+
+	// Updates the pointer along the reading direction, which goes back
+	// along the axis at 180 and 270 degrees.
+	int16_t step = (rotation >= SSD1306_ROTATION_180) ? -font->fontWidth :
+		font->fontWidth;
+
+	if (vertical) {
+		SSD1306.currentY += step;
+	} else {
+		SSD1306.currentX += step;
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_putsRotated(char *str, FontDef_t *font,
+	SSD1306_rotation_t rotation, SSD1306_color_t color,
+	SSD1306_textMode_t mode) {
+
+	SSD1306_status_t status = LCD_OK;
+	FontStringSize_t size;
+	const char *s = str;
+	uint16_t cp, fit;
+
+	if (rotation == SSD1306_ROTATION_0) {
+		return SSD1306_putsMode(str, font, color, mode);
+	}
+
+	if (rotation > SSD1306_ROTATION_270) {
+		return INVALID_PARAMS;
+	}
+
+	uint8_t vertical = (rotation == SSD1306_ROTATION_90 ||
+		rotation == SSD1306_ROTATION_270);
+
+	if (vertical) {
+		if (SSD1306.currentY >= SSD1306_HEIGHT ||
+			SSD1306_WIDTH < (SSD1306.currentX + font->fontHeight)) {
+
+			return INVALID_PARAMS;
+		}
+
+		fit = (SSD1306_HEIGHT - SSD1306.currentY) / font->fontWidth;
+	} else {
+		if (SSD1306.currentX >= SSD1306_WIDTH ||
+			SSD1306_HEIGHT < (SSD1306.currentY + font->fontHeight)) {
+
+			return INVALID_PARAMS;
+		}
+
+		fit = (SSD1306_WIDTH - SSD1306.currentX) / font->fontWidth;
+	}
+
+	// The glyph count is needed up front, since at 180 and 270 degrees the
+	// first glyph is drawn at the far end of the string box.
+	get_string_size(str, &size, font);
+
+	uint16_t n = size.length / font->fontWidth;
+
+	if (n > fit) {
+		n = fit;
+		status = INVALID_PARAMS;
+	}
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	for (uint16_t i = 0; i < n && (cp = get_code_point(&s)) != 0; i++) {
+		int16_t index = get_glyph_index(font, cp);
+		uint16_t pos = (rotation == SSD1306_ROTATION_90) ? i : n - 1 - i;
+		uint16_t x = SSD1306.currentX;
+		uint16_t y = SSD1306.currentY;
+
+		if (vertical) {
+			y += pos * font->fontWidth;
+		} else {
+			x += pos * font->fontWidth;
+		}
+
+		if (index < 0) {
+			status = INVALID_PARAMS;
+		} else {
+			SSD1306_renderGlyphRotated(x, y, index, font, rotation, color,
+				mode);
+		}
+	}
+
+	// Moves the pointer past the string box.
+	if (vertical) {
+		SSD1306.currentY += n * font->fontWidth;
+	} else {
+		SSD1306.currentX += n * font->fontWidth;
+	}
+
+	return status;
+}
+
+
+SSD1306_status_t SSD1306_putInt(int32_t num, uint8_t base, FontDef_t *font,
+	SSD1306_color_t color) {
+
+	char buff[SSD1306_NUM_MAX_CHARS + 1];
+
+	if (base < 2 || base > 32) {
+		return INVALID_PARAMS;
+	}
+
+	uint8_t len = SSD1306_formatNum(buff, SSD1306_NUM_MAX_CHARS, num, base, 0,
+		' ');
+	buff[SSD1306_NUM_MAX_CHARS] = '\0';
+
+	// Prints the string of the converted integer.
+	return SSD1306_puts(&buff[SSD1306_NUM_MAX_CHARS - len], font, color);
+}
+
+
+SSD1306_status_t SSD1306_putIntPadded(int32_t num, uint8_t base,
+	uint8_t width, char pad, FontDef_t *font, SSD1306_color_t color) {
+
+	char buff[SSD1306_NUM_MAX_CHARS + 1];
+
+	if (base < 2 || base > 32 || width == 0 || width > SSD1306_NUM_MAX_CHARS) {
+		return INVALID_PARAMS;
+	}
+
+	if (!SSD1306_formatNum(buff, width, num, base, 0, pad)) {
+		return INVALID_PARAMS;
+	}
+	buff[width] = '\0';
+
+	return SSD1306_puts(buff, font, color);
+}
+
+
+SSD1306_status_t SSD1306_putFixed(int32_t num, uint8_t decimals,
+	uint8_t width, FontDef_t *font, SSD1306_color_t color) {
+
+	char buff[SSD1306_NUM_MAX_CHARS + 1];
+
+	if (width == 0 || width > SSD1306_NUM_MAX_CHARS) {
+		return INVALID_PARAMS;
+	}
+
+	if (!SSD1306_formatNum(buff, width, num, 10, decimals, ' ')) {
+		return INVALID_PARAMS;
+	}
+	buff[width] = '\0';
+
+	return SSD1306_puts(buff, font, color);
+}
+
+
+SSD1306_status_t SSD1306_putHex(uint32_t num, uint8_t digits, FontDef_t *font,
+	SSD1306_color_t color) {
+
+	char buff[9];
+
+	if (digits == 0 || digits > 8) {
+		return INVALID_PARAMS;
+	}
+
+	for (int8_t i = digits - 1; i >= 0; i--) {
+		uint8_t nibble = num & 0x0F;
+		buff[i] = (nibble > 9) ? (nibble - 10) + 'A' : nibble + '0';
+		num >>= 4;
+	}
+	buff[digits] = '\0';
+
+	return SSD1306_puts(buff, font, color);
+}
+
+
+SSD1306_status_t SSD1306_initNumField(SSD1306_numField_t *field, uint16_t x,
+	uint16_t y, uint8_t width, uint8_t decimals, uint8_t base, char pad,
+	FontDef_t *font, SSD1306_color_t color) {
+
+	if (field == NULL || font == NULL) {
+		return INVALID_PARAMS;
+	}
+
+	if (base < 2 || base > 32 || width == 0 || width > SSD1306_NUM_MAX_CHARS) {
+		return INVALID_PARAMS;
+	}
+
+	if (SSD1306_WIDTH < x + width * font->fontWidth ||
+		SSD1306_HEIGHT < y + font->fontHeight) {
+
+		return INVALID_PARAMS;
+	}
+
+	field->x = x;
+	field->y = y;
+	field->width = width;
+	field->decimals = decimals;
+	field->base = base;
+	field->pad = pad;
+	field->font = font;
+	field->color = color;
+
+	// Nothing has been drawn yet: no formatted character matches '\0'.
+	memset(field->last, 0, sizeof(field->last));
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_updateNumField(SSD1306_numField_t *field,
+	int32_t num) {
+
+	char buff[SSD1306_NUM_MAX_CHARS];
+	SSD1306_color_t color = field->color;
+
+	if (!SSD1306_formatNum(buff, field->width, num, field->base,
+		field->decimals, field->pad)) {
+
+		return INVALID_PARAMS;
+	}
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	// Redraws only the characters that differ from the previous value.
+	for (uint8_t i = 0; i < field->width; i++) {
+		if (buff[i] != field->last[i]) {
+			int16_t index = get_glyph_index(field->font, (uint8_t)buff[i]);
+
+			if (index >= 0) {
+				SSD1306_renderGlyph(field->x + i * field->font->fontWidth,
+					field->y, index, field->font, color, SSD1306_TEXT_OPAQUE);
+			}
+			field->last[i] = buff[i];
+		}
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_initTextBox(SSD1306_textBox_t *box, int16_t x,
+	int16_t y, int16_t w, int16_t h, FontDef_t *font, SSD1306_align_t align,
+	uint8_t ellipsis) {
+
+	if (box == NULL || font == NULL || align > SSD1306_ALIGN_RIGHT ||
+		x < 0 || y < 0 || w < font->fontWidth || h < font->fontHeight ||
+		x + w > SSD1306_WIDTH || y + h > SSD1306_HEIGHT) {
+
+		return INVALID_PARAMS;
+	}
+
+	box->x = x;
+	box->y = y;
+	box->w = w;
+	box->h = h;
+	box->font = font;
+	box->align = align;
+	box->ellipsis = ellipsis;
+
+	// No string has been laid out yet.
+	box->str = NULL;
+	box->hash = 0;
+	box->lineCount = 0;
+	box->truncated = 0;
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_layoutText(SSD1306_textBox_t *box, const char *str) {
+	uint32_t hash = 2166136261u;
+
+	if (box == NULL || str == NULL) {
+		return INVALID_PARAMS;
+	}
+
+	// FNV-1a hash of the content, so that a string changed in place is laid
+	// out again.
+	for (const char *c = str; *c; c++) {
+		hash = (hash ^ (uint8_t)*c) * 16777619u;
+	}
+
+	if (box->str == str && box->hash == hash) {
+		return box->truncated ? INVALID_PARAMS : LCD_OK;
+	}
+
+	uint8_t cols = box->w / box->font->fontWidth;
+	uint8_t rows = box->h / box->font->fontHeight;
+	const char *p = str;
+
+	if (rows > SSD1306_TEXT_MAX_LINES) {
+		rows = SSD1306_TEXT_MAX_LINES;
+	}
+
+	box->lineCount = 0;
+
+	while (*p && box->lineCount < rows) {
+		const char *q = p, *end = p, *next = p;
+		const char *brk_end = NULL, *brk_next = NULL;
+		uint8_t n = 0, brk_n = 0;
+
+		while (1) {
+			const char *s = q;
+			uint16_t cp = get_code_point(&q);
+
+			if (cp == 0 || cp == '\n') {
+				end = s;
+				next = q;
+				break;
+			}
+
+			// The line is full: breaks at this space, after the last word
+			// that fits or, failing that, inside the word.
+			if (n == cols) {
+				if (cp == ' ') {
+					end = s;
+					next = q;
+				} else if (brk_end != NULL) {
+					end = brk_end;
+					next = brk_next;
+					n = brk_n;
+				} else {
+					end = s;
+					next = s;
+				}
+
+				// A wrapped line does not start with spaces.
+				while (*next == ' ') {
+					next++;
+				}
+				break;
+			}
+
+			if (cp == ' ') {
+				brk_end = s;
+				brk_next = q;
+				brk_n = n;
+			}
+
+			n++;
+		}
+
+		// Trailing spaces would shift aligned lines.
+		while (end > p && end[-1] == ' ') {
+			end--;
+			n--;
+		}
+
+		box->lines[box->lineCount].start = p - str;
+		box->lines[box->lineCount].bytes = end - p;
+		box->lines[box->lineCount].glyphs = n;
+		box->lineCount++;
+
+		p = next;
+	}
+
+	box->truncated = (*p != '\0');
+	box->str = str;
+	box->hash = hash;
+
+	// Makes room for the ellipsis at the end of the last line.
+	if (box->truncated && box->ellipsis && box->lineCount > 0) {
+		SSD1306_textLine_t *line = &box->lines[box->lineCount - 1];
+		uint8_t keep = (cols > 3) ? cols - 3 : 0;
+
+		if (line->glyphs > keep) {
+			const char *c = str + line->start;
+
+			for (uint8_t i = 0; i < keep; i++) {
+				get_code_point(&c);
+			}
+
+			line->bytes = c - (str + line->start);
+			line->glyphs = keep;
+		}
+	}
+
+	return box->truncated ? INVALID_PARAMS : LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawTextBox(SSD1306_textBox_t *box, const char *str,
+	SSD1306_color_t color, SSD1306_textMode_t mode) {
+
+	if (box == NULL || str == NULL) {
+		return INVALID_PARAMS;
+	}
+
+	SSD1306_status_t status = SSD1306_layoutText(box, str);
+	FontDef_t *font = box->font;
+	uint8_t cols = box->w / font->fontWidth;
+	int16_t dot = get_glyph_index(font, '.');
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	if (mode == SSD1306_TEXT_OPAQUE) {
+		SSD1306_fillRegion(box->x, box->y, box->x + box->w - 1,
+			box->y + box->h - 1, (SSD1306_color_t)!color);
+	}
+
+	for (uint8_t i = 0; i < box->lineCount; i++) {
+		const SSD1306_textLine_t *line = &box->lines[i];
+		const char *c = str + line->start;
+		const char *end = c + line->bytes;
+		uint8_t dots = 0;
+
+		if (box->truncated && box->ellipsis && i == box->lineCount - 1) {
+			dots = (cols < 3) ? cols : 3;
+		}
+
+		// Offset of the line within the box.
+		int16_t width = (line->glyphs + dots) * font->fontWidth;
+		int16_t x = box->x;
+		uint16_t y = box->y + i * font->fontHeight;
+
+		if (box->align == SSD1306_ALIGN_CENTER) {
+			x += (box->w - width) / 2;
+		} else if (box->align == SSD1306_ALIGN_RIGHT) {
+			x += box->w - width;
+		}
+
+		while (c < end) {
+			int16_t index = get_glyph_index(font, get_code_point(&c));
+
+			if (index >= 0) {
+				SSD1306_renderGlyph(x, y, index, font, color,
+					SSD1306_TEXT_TRANSPARENT);
+			}
+			x += font->fontWidth;
+		}
+
+		for (uint8_t d = 0; d < dots && dot >= 0; d++) {
+			SSD1306_renderGlyph(x, y, dot, font, color,
+				SSD1306_TEXT_TRANSPARENT);
+			x += font->fontWidth;
+		}
+	}
+
+	return status;
+}
+
+
+SSD1306_status_t SSD1306_initSegDisplay(SSD1306_segDisplay_t *disp, int16_t x,
+	int16_t y, uint8_t digits, uint8_t decimals, uint8_t digit_w,
+	uint8_t digit_h, uint8_t thickness, SSD1306_color_t color) {
+
+	if (disp == NULL || digits == 0 || digits > SSD1306_SEG_MAX_DIGITS ||
+		decimals >= digits || thickness == 0 ||
+		digit_w < 2 * thickness + 1 || digit_h < 3 * thickness + 2) {
+
+		return INVALID_PARAMS;
+	}
+
+	if (x < 0 || y < 0 ||
+		x + digits * (digit_w + thickness + 2) - thickness - 2 > SSD1306_WIDTH ||
+		y + digit_h > SSD1306_HEIGHT) {
+
+		return INVALID_PARAMS;
+	}
+
+	disp->x = x;
+	disp->y = y;
+	disp->digitW = digit_w;
+	disp->digitH = digit_h;
+	disp->thickness = thickness;
+	disp->digits = digits;
+	disp->decimals = decimals;
+	disp->color = color;
+	disp->drawn = 0;
+	memset(disp->dirty, 0, sizeof(disp->dirty));
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_updateSegDisplay(SSD1306_segDisplay_t *disp,
+	int32_t num) {
+
+	// Segments a to g of the digits 0 to 9.
+	static const uint8_t digit_segs[10] = {
+		0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F
+	};
+	char buff[SSD1306_SEG_MAX_DIGITS + 1];
+	uint8_t width = disp->digits + (disp->decimals ? 1 : 0);
+	SSD1306_color_t on = disp->color;
+	int16_t box[8][4];
+
+	if (!SSD1306_formatNum(buff, width, num, 10, disp->decimals, ' ')) {
+		return INVALID_PARAMS;
+	}
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		on = (SSD1306_color_t)!on;
+	}
+
+	SSD1306_segBoxes(disp, box);
+
+	for (uint8_t i = 0, k = 0; i < disp->digits; i++, k++) {
+		uint8_t segs = 0;
+
+		if (buff[k] >= '0' && buff[k] <= '9') {
+			segs = digit_segs[buff[k] - '0'];
+		} else if (buff[k] == '-') {
+			segs = 0x40;
+		}
+
+		// The decimal point is lit on the digit before it.
+		if (k + 1 < width && buff[k + 1] == '.') {
+			segs |= 0x80;
+			k++;
+		}
+
+		uint8_t diff = disp->drawn ? (segs ^ disp->last[i]) : 0xFF;
+
+		// Only the digit before the decimals has a decimal point.
+		if (disp->decimals == 0 || i != disp->digits - disp->decimals - 1) {
+			diff &= 0x7F;
+		}
+		int16_t cx = SSD1306_segDigitX(disp, i);
+
+		disp->dirty[i] |= diff;
+
+		for (uint8_t b = 0; diff; b++, diff >>= 1) {
+			if (diff & 0x01) {
+				SSD1306_fillRegion(cx + box[b][0], disp->y + box[b][1],
+					cx + box[b][2], disp->y + box[b][3],
+					(segs & (1 << b)) ? on : (SSD1306_color_t)!on);
+			}
+		}
+
+		disp->last[i] = segs;
+	}
+
+	disp->drawn = 1;
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_flushSegDisplay(SSD1306_segDisplay_t *disp) {
+	int16_t box[8][4];
+
+	SSD1306_segBoxes(disp, box);
+
+	for (uint8_t i = 0; i < disp->digits; i++) {
+		int16_t x0 = INT16_MAX, y0 = INT16_MAX, x1 = INT16_MIN, y1 = INT16_MIN;
+		uint8_t dirty = disp->dirty[i];
+
+		if (dirty == 0) {
+			continue;
+		}
+
+		// Box of the changed segments of the digit.
+		for (uint8_t b = 0; dirty; b++, dirty >>= 1) {
+			if (dirty & 0x01) {
+				if (box[b][0] < x0) x0 = box[b][0];
+				if (box[b][1] < y0) y0 = box[b][1];
+				if (box[b][2] > x1) x1 = box[b][2];
+				if (box[b][3] > y1) y1 = box[b][3];
+			}
+		}
+
+		SSD1306_status_t status = SSD1306_updateArea(
+			SSD1306_segDigitX(disp, i) + x0, disp->y + y0, x1 - x0 + 1,
+			y1 - y0 + 1);
+
+		if (status != LCD_OK) {
+			return status;
+		}
+
+		disp->dirty[i] = 0;
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawLine(uint16_t x0, uint16_t y0, uint16_t x1,
+	uint16_t y1, SSD1306_color_t color) {
+
+	int16_t dx, dy, sx, sy, err, e2, tmp;
+
+	if (x0 >= SSD1306_WIDTH) {
+		x0 = SSD1306_WIDTH - 1;
+	}
+
+	if (x1 >= SSD1306_WIDTH) {
+		x1 = SSD1306_WIDTH - 1;
+	}
+
+	if (y0 >= SSD1306_HEIGHT) {
+		y0 = SSD1306_HEIGHT - 1;
+	}
+
+	if (y1 >= SSD1306_HEIGHT) {
+		y1 = SSD1306_HEIGHT - 1;
+	}
+
+	dx = (x0 < x1) ? (x1 - x0) : (x0 - x1);
+	dy = (y0 < y1) ? (y1 - y0) : (y0 - y1);
+	sx = (x0 < x1) ? 1 : -1;
+	sy = (y0 < y1) ? 1 : -1;
+
+	// Shifting by 1 means diving by two.
+	err = ((dx > dy) ? dx : -dy) >> 1;
+
+	// Draws vertical line.
+	if (dx == 0) {
+		if (y1 < y0) {
+			tmp = y1;
+			y1 = y0;
+			y0 = tmp;
+		}
+
+		if (x1 < x0) {
+			tmp = x1;
+			x0 = tmp;
+		}
+
+		/* Vertical line */
+		if (SSD1306.inverted) {
+			color = (SSD1306_color_t)!color;
+		}
+		SSD1306_fillRegion(x0, y0, x0, y1, color);
+
+		/* Return from function */
+		return LCD_OK;
+	}
+
+	// Draws horizontal line.
+	if (dy == 0) {
+		if (y1 < y0) {
+			tmp = y1;
+			y0 = tmp;
+		}
+
+		if (x1 < x0) {
+			tmp = x1;
+			x1 = x0;
+			x0 = tmp;
+		}
+
+		/* Horizontal line */
+		if (SSD1306.inverted) {
+			color = (SSD1306_color_t)!color;
+		}
+		SSD1306_fillRegion(x0, y0, x1, y0, color);
+
+		/* Return from function */
+		return LCD_OK;
+	}
+
+	while (1) {
+		SSD1306_drawPixel(x0, y0, color);
+		if (x0 == x1 && y0 == y1) {
+			break;
+		}
+		e2 = err;
+		if (e2 > -dx) {
+			err -= dy;
+			x0 += sx;
+		}
+		if (e2 < dy) {
+			err += dx;
+			y0 += sy;
+		}
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawRectangle(uint16_t x, uint16_t y, uint16_t w,
+	uint16_t h, SSD1306_color_t color) {
+
+	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+		return INVALID_PARAMS;
+	}
+
+	/* Check width and height */
+	if ((x + w) >= SSD1306_WIDTH) {
+		w = SSD1306_WIDTH - x;
+	}
+	if ((y + h) >= SSD1306_HEIGHT) {
+		h = SSD1306_HEIGHT - y;
+	}
+
+	// Draws 4 lines.
+	SSD1306_drawLine(x, y, x + w, y, color);         /* Top line */
+	SSD1306_drawLine(x, y + h, x + w, y + h, color); /* Bottom line */
+	SSD1306_drawLine(x, y, x, y + h, color);         /* Left line */
+	SSD1306_drawLine(x + w, y, x + w, y + h, color); /* Right line */
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawFilledRectangle(uint16_t x, uint16_t y, uint16_t w,
+	uint16_t h, SSD1306_color_t color) {
+
+	/* Check input parameters */
+	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+		return INVALID_PARAMS;
+	}
+
+	if ((y + h) >= SSD1306_HEIGHT) {
+		h = SSD1306_HEIGHT - 1 - y;
+	}
+
+	if ((x + w) >= SSD1306_WIDTH) {
+		w = SSD1306_WIDTH - 1 - x;
+	}
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	SSD1306_fillRegion(x, y, x + w, y + h, color);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawTriangle(uint16_t x1, uint16_t y1, uint16_t x2,
+	uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_color_t color) {
+
+	SSD1306_drawLine(x1, y1, x2, y2, color);
+	SSD1306_drawLine(x2, y2, x3, y3, color);
+	SSD1306_drawLine(x3, y3, x1, y1, color);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawFilledTriangle(uint16_t x1, uint16_t y1,
+	uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_color_t color) {
+
+	int16_t xa = x1, ya = y1, xb = x2, yb = y2, xc = x3, yc = y3, tmp;
+
+	// Sorts the vertices by Y location (ya <= yb <= yc).
+	if (ya > yb) {
+		tmp = ya; ya = yb; yb = tmp;
+		tmp = xa; xa = xb; xb = tmp;
+	}
+	if (yb > yc) {
+		tmp = yb; yb = yc; yc = tmp;
+		tmp = xb; xb = xc; xc = tmp;
+	}
+	if (ya > yb) {
+		tmp = ya; ya = yb; yb = tmp;
+		tmp = xa; xa = xb; xb = tmp;
+	}
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	// All the vertices lie on the same scanline.
+	if (ya == yc) {
+		int16_t left = xa, right = xa;
+
+		if (xb < left) left = xb;
+		if (xb > right) right = xb;
+		if (xc < left) left = xc;
+		if (xc > right) right = xc;
+
+		SSD1306_fillSpan(left, right, ya, color);
+
+		return LCD_OK;
+	}
+
+	int32_t dx_ab = xb - xa, dy_ab = yb - ya;
+	int32_t dx_ac = xc - xa, dy_ac = yc - ya;
+	int32_t dx_bc = xc - xb, dy_bc = yc - yb;
+	int32_t sa = 0, sb = 0;
+	int16_t y, last;
+
+	// The upper part goes from ya to yb, the scanline yb included only if
+	// the lower part is flat.
+	last = (yb == yc) ? yb : yb - 1;
+
+	for (y = ya; y <= last; y++) {
+		SSD1306_fillSpan(xa + sa / dy_ab, xa + sb / dy_ac, y, color);
+		sa += dx_ab;
+		sb += dx_ac;
+	}
+
+	// The lower part goes from yb to yc.
+	sa = dx_bc * (y - yb);
+	sb = dx_ac * (y - ya);
+
+	for (; y <= yc; y++) {
+		SSD1306_fillSpan(xb + sa / dy_bc, xa + sb / dy_ac, y, color);
+		sa += dx_bc;
+		sb += dx_ac;
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawFilledPolygon(const SSD1306_point_t *points,
+	uint8_t n, SSD1306_color_t color) {
+
+	int16_t nodes[SSD1306_POLYGON_MAX_VERTICES];
+	int16_t y_min, y_max;
+
+	if (points == NULL || n < 3 || n > SSD1306_POLYGON_MAX_VERTICES) {
+		return INVALID_PARAMS;
+	}
+
+	y_min = y_max = points[0].y;
+	for (uint8_t i = 1; i < n; i++) {
+		if (points[i].y < y_min) y_min = points[i].y;
+		if (points[i].y > y_max) y_max = points[i].y;
+	}
+
+	// Only the visible scanlines are processed.
+	if (y_min < 0) y_min = 0;
+	if (y_max >= SSD1306_HEIGHT) y_max = SSD1306_HEIGHT - 1;
+
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
+
+	for (int16_t y = y_min; y <= y_max; y++) {
+		uint8_t count = 0;
+
+		// Collects the X locations where the edges cross the scanline. Each
+		// edge covers the half-open interval [top, bottom), except on the
+		// last scanline so that bottom vertices and edges are filled too.
+		for (uint8_t i = 0, j = n - 1; i < n; j = i++) {
+			int16_t yi = points[i].y, yj = points[j].y;
+			uint8_t crosses;
+
+			if (y < y_max) {
+				crosses = (yi <= y && y < yj) || (yj <= y && y < yi);
+			} else {
+				crosses = (yi < y && y <= yj) || (yj < y && y <= yi);
+			}
+
+			if (crosses) {
+				int16_t x = points[i].x + (int32_t)(y - yi) *
+					(points[j].x - points[i].x) / (yj - yi);
+
+				// Insertion sort keeps the crossings ordered.
+				uint8_t k = count++;
+				while (k > 0 && nodes[k - 1] > x) {
+					nodes[k] = nodes[k - 1];
+					k--;
+				}
+				nodes[k] = x;
+			}
+		}
 
-	SSD1306_clear();
-	SSD1306.initialized = 1;
+		// Fills between pairs of crossings (even-odd rule).
+		for (uint8_t k = 0; k + 1 < count; k += 2) {
+			SSD1306_fillSpan(nodes[k], nodes[k + 1], y, color);
+		}
+	}
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_clear(void) {
-	if (!SSD1306.initialized) {
-		return NO_INIT;
-	}
+SSD1306_status_t SSD1306_drawCircle(int16_t x0, int16_t y0, int16_t r,
+	SSD1306_color_t color) {
 
-	SSD1306_fill(SSD1306_COLOR_BLACK);
-	SSD1306_updateScreen();
+	int16_t f = 1 - r;
+	int16_t ddF_x = 1;
+	int16_t ddF_y = -2 * r;
+	int16_t x = 0;
+	int16_t y = r;
 
-	return LCD_OK;
-}
+    SSD1306_drawPixel(x0, y0 + r, color);
+    SSD1306_drawPixel(x0, y0 - r, color);
+    SSD1306_drawPixel(x0 + r, y0, color);
+    SSD1306_drawPixel(x0 - r, y0, color);
 
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
 
-SSD1306_status_t SSD1306_invertDisplay(uint8_t is_inverted) {
-	if (!SSD1306.initialized) {
-		return NO_INIT;
-	}
+        SSD1306_drawPixel(x0 + x, y0 + y, color);
+        SSD1306_drawPixel(x0 - x, y0 + y, color);
+        SSD1306_drawPixel(x0 + x, y0 - y, color);
+        SSD1306_drawPixel(x0 - x, y0 - y, color);
 
-	if (is_inverted)
-		SSD1306_WRITECOMMAND(SSD1306_INVERTDISPLAY);
-	else
-		SSD1306_WRITECOMMAND(SSD1306_NORMALDISPLAY);
+        SSD1306_drawPixel(x0 + y, y0 + x, color);
+        SSD1306_drawPixel(x0 - y, y0 + x, color);
+        SSD1306_drawPixel(x0 + y, y0 - x, color);
+        SSD1306_drawPixel(x0 - y, y0 - x, color);
+    }
 
-	return LCD_OK;
+    return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_updateScreen(void) {
-	if (!SSD1306.initialized) {
-		return NO_INIT;
-	}
+SSD1306_status_t SSD1306_drawFilledCircle(int16_t x0, int16_t y0, int16_t r,
+	SSD1306_color_t color) {
 
-	for (uint8_t m = 0; m < 8; m++) {
-		SSD1306_WRITECOMMAND(0xB0 + m);
-		SSD1306_WRITECOMMAND(0x00);
-		SSD1306_WRITECOMMAND(0x10);
+	if (r < 0 || r > SSD1306_WIDTH) {
+		return INVALID_PARAMS;
+	}
 
-		SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x40,
-			&SSD1306_Buffer[SSD1306_WIDTH * m], SSD1306_WIDTH);
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
 	}
 
+	SSD1306_drawRoundShape(x0, x0, y0, y0, r, r, 1, color);
+
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_toggleInvert(void) {
-	if (!SSD1306.initialized) {
-		return NO_INIT;
+SSD1306_status_t SSD1306_drawEllipse(int16_t x0, int16_t y0, int16_t rx,
+	int16_t ry, SSD1306_color_t color) {
+
+	if (rx < 0 || ry < 0 || rx > SSD1306_WIDTH || ry > SSD1306_HEIGHT) {
+		return INVALID_PARAMS;
 	}
 
-	for (uint32_t i = 0; i < sizeof(SSD1306_Buffer); i++) {
-		SSD1306_Buffer[i] = ~SSD1306_Buffer[i];
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
 	}
 
-	// Updates internal status.
-	SSD1306.inverted = !SSD1306.inverted;
+	SSD1306_drawRoundShape(x0, x0, y0, y0, rx, ry, 0, color);
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_scrollRight(uint8_t start_page, uint8_t end_page) {
-	if (start_page >= SSD1306_MAX_PAGE_NUM ||
-		end_page >= SSD1306_MAX_PAGE_NUM) {
+SSD1306_status_t SSD1306_drawFilledEllipse(int16_t x0, int16_t y0, int16_t rx,
+	int16_t ry, SSD1306_color_t color) {
 
+	if (rx < 0 || ry < 0 || rx > SSD1306_WIDTH || ry > SSD1306_HEIGHT) {
 		return INVALID_PARAMS;
 	}
 
-	if (start_page > end_page) {
-		return INVALID_PARAMS;
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
 	}
 
-	// Right horizontal scroll.
-	SSD1306_WRITECOMMAND(SSD1306_RIGHT_HORIZONTAL_SCROLL);
-	SSD1306_WRITECOMMAND(0x00);       // Dummy byte.
-	SSD1306_WRITECOMMAND(start_page); // Start page address.
-
-	// Time interval between each scroll step as 5 frames.
-	SSD1306_WRITECOMMAND(0X00);
-
-	SSD1306_WRITECOMMAND(end_page);   // End page address.
-	SSD1306_WRITECOMMAND(0X00);
-	SSD1306_WRITECOMMAND(0xFF);		  // Scroll offset for continuous movement.
-	SSD1306_WRITECOMMAND(SSD1306_ACTIVATE_SCROLL); // Start scrolling.
+	SSD1306_drawRoundShape(x0, x0, y0, y0, rx, ry, 1, color);
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_scrollLeft(uint8_t start_page, uint8_t end_page) {
-	if (start_page >= SSD1306_MAX_PAGE_NUM ||
-		end_page >= SSD1306_MAX_PAGE_NUM) {
-
-		return INVALID_PARAMS;
-	}
+SSD1306_status_t SSD1306_drawRoundRect(int16_t x, int16_t y, int16_t w,
+	int16_t h, int16_t r, SSD1306_color_t color) {
 
-	if (start_page > end_page) {
+	if (w <= 0 || h <= 0 || r < 0) {
 		return INVALID_PARAMS;
 	}
 
-	// Left horizontal scroll.
-	SSD1306_WRITECOMMAND(SSD1306_LEFT_HORIZONTAL_SCROLL);
-	SSD1306_WRITECOMMAND(0x00);  	  // Dummy byte.
-	SSD1306_WRITECOMMAND(start_page); // Start page address.
+	// The corners cannot be larger than half the shortest side.
+	if (r > (w - 1) / 2) r = (w - 1) / 2;
+	if (r > (h - 1) / 2) r = (h - 1) / 2;
 
-	// Time interval between each scroll step as 5 frames.
-	SSD1306_WRITECOMMAND(0X00);
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
 
-	SSD1306_WRITECOMMAND(end_page);  // End page address.
-	SSD1306_WRITECOMMAND(0X00);
-	SSD1306_WRITECOMMAND(0XFF);
-	SSD1306_WRITECOMMAND(SSD1306_ACTIVATE_SCROLL); // Start scrolling.
+	SSD1306_drawRoundShape(x + r, x + w - 1 - r, y + r, y + h - 1 - r, r, r, 0,
+		color);
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_scrollDiagRight(uint8_t start_page, uint8_t end_page) {
-	if (start_page >= SSD1306_MAX_PAGE_NUM ||
-		end_page >= SSD1306_MAX_PAGE_NUM) {
+SSD1306_status_t SSD1306_drawFilledRoundRect(int16_t x, int16_t y, int16_t w,
+	int16_t h, int16_t r, SSD1306_color_t color) {
 
+	if (w <= 0 || h <= 0 || r < 0) {
 		return INVALID_PARAMS;
 	}
 
-	if (start_page > end_page) {
-		return INVALID_PARAMS;
-	}
+	// The corners cannot be larger than half the shortest side.
+	if (r > (w - 1) / 2) r = (w - 1) / 2;
+	if (r > (h - 1) / 2) r = (h - 1) / 2;
 
-	SSD1306_WRITECOMMAND(SSD1306_SET_VERTICAL_SCROLL_AREA);
-	SSD1306_WRITECOMMAND(0x00); 					// Dummy byte.
-	SSD1306_WRITECOMMAND(SSD1306_HEIGHT);
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
+	}
 
-	SSD1306_WRITECOMMAND(SSD1306_VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL);
-	SSD1306_WRITECOMMAND(0x00);
-	SSD1306_WRITECOMMAND(start_page);				// Start page address.
-	SSD1306_WRITECOMMAND(0X00);
-	SSD1306_WRITECOMMAND(end_page);					// End page address.
-	SSD1306_WRITECOMMAND(0x01);
-	SSD1306_WRITECOMMAND(SSD1306_ACTIVATE_SCROLL);
+	if (r == 0) {
+		SSD1306_fillRegion(x, y, x + w - 1, y + h - 1, color);
+	} else {
+		SSD1306_drawRoundShape(x + r, x + w - 1 - r, y + r, y + h - 1 - r, r, r,
+			1, color);
+	}
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_scrollDiagLeft(uint8_t start_page, uint8_t end_page) {
-	if (start_page >= SSD1306_MAX_PAGE_NUM ||
-		end_page >= SSD1306_MAX_PAGE_NUM) {
+SSD1306_status_t SSD1306_invertRect(int16_t x, int16_t y, int16_t w,
+	int16_t h) {
 
+	if (w <= 0 || h <= 0) {
 		return INVALID_PARAMS;
 	}
 
-	if (start_page > end_page) {
+	SSD1306_maskRegion(x, y, x + w - 1, y + h - 1, 0x00, 0x00, 0xFF);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_drawImage(int16_t x, int16_t y, const uint8_t *image,
+	int16_t w, int16_t h, SSD1306_rop_t rop) {
+
+	uint8_t row[SSD1306_WIDTH];
+	int16_t pages = (h + 7) >> 3;
+
+	if (image == NULL || w <= 0 || h <= 0 || rop > SSD1306_ROP_XOR) {
 		return INVALID_PARAMS;
 	}
 
-	SSD1306_WRITECOMMAND(SSD1306_SET_VERTICAL_SCROLL_AREA);
-	SSD1306_WRITECOMMAND(0x00);						// Dummy byte.
-	SSD1306_WRITECOMMAND(SSD1306_HEIGHT);
+	// Visible part of the image.
+	int16_t x0 = (x < SSD1306_Clip.x0) ? SSD1306_Clip.x0 : x;
+	int16_t x1 = (x + w - 1 > SSD1306_Clip.x1) ? SSD1306_Clip.x1 : x + w - 1;
+	int16_t y0 = (y < SSD1306_Clip.y0) ? SSD1306_Clip.y0 : y;
+	int16_t y1 = (y + h - 1 > SSD1306_Clip.y1) ? SSD1306_Clip.y1 : y + h - 1;
 
-	SSD1306_WRITECOMMAND(SSD1306_VERTICAL_AND_LEFT_HORIZONTAL_SCROLL);
-	SSD1306_WRITECOMMAND(0x00);
-	SSD1306_WRITECOMMAND(start_page);				// Start page address.
-	SSD1306_WRITECOMMAND(0X00);
-    SSD1306_WRITECOMMAND(end_page);					// End page address.
-    SSD1306_WRITECOMMAND(0x01);
-    SSD1306_WRITECOMMAND(SSD1306_ACTIVATE_SCROLL);
+	if (x0 > x1 || y0 > y1) {
+		return LCD_OK;
+	}
 
-    return LCD_OK;
-}
+	uint16_t n = x1 - x0 + 1;
+	uint8_t inv = SSD1306.inverted ? 0xFF : 0x00;
 
+	for (uint8_t page = y0 >> 3; page <= (y1 >> 3); page++) {
+		uint8_t *dst = SSD1306_page(page);
+		uint8_t m = 0xFF;
 
-SSD1306_status_t SSD1306_stopScroll(void) {
-	SSD1306_WRITECOMMAND(SSD1306_DEACTIVATE_SCROLL);
+		if (dst == NULL) {
+			continue;
+		}
 
-	return LCD_OK;
-}
+		if (page == (y0 >> 3)) {
+			m &= 0xFF << (y0 & 0x07);
+		}
+		if (page == (y1 >> 3)) {
+			m &= 0xFF >> (7 - (y1 & 0x07));
+		}
 
+		// The page starts at image row 8 * q + shift.
+		int16_t top = page * 8 - y;
+		int16_t q = (top >= 0) ? (top >> 3) : -((7 - top) >> 3);
+		uint8_t shift = top - q * 8;
+		const uint8_t *lo = (q >= 0) ? &image[q * w + (x0 - x)] : NULL;
+		const uint8_t *hi = (q + 1 < pages) ? &image[(q + 1) * w + (x0 - x)] :
+			NULL;
+
+		if (shift == 0) {
+			SSD1306_composeBytes(dst + x0, lo, n, m, inv, rop);
+			continue;
+		}
 
-SSD1306_status_t SSD1306_fill(SSD1306_color_t color) {
-	if (!SSD1306.initialized) {
-		return NO_INIT;
-	}
+		for (uint16_t i = 0; i < n; i++) {
+			row[i] = (lo ? (lo[i] >> shift) : 0) |
+				(hi ? (hi[i] << (8 - shift)) : 0);
+		}
 
-	switch (color) {
-		case SSD1306_COLOR_BLACK:
-			memset(SSD1306_Buffer, 0x00, sizeof(SSD1306_Buffer));
-			break;
-		case SSD1306_COLOR_WHITE:
-			memset(SSD1306_Buffer, 0xFF, sizeof(SSD1306_Buffer));
-			break;
-		default:
-			return INVALID_PARAMS;
+		SSD1306_composeBytes(dst + x0, row, n, m, inv, rop);
 	}
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_drawPixel(uint16_t x, uint16_t y, SSD1306_color_t color) {
-	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+SSD1306_status_t SSD1306_drawPackedImage(int16_t x, int16_t y,
+	const SSD1306_image_t *image, SSD1306_rop_t rop) {
+
+	SSD1306_imageReader_t reader = { 0 };
+	uint8_t row[SSD1306_WIDTH];
+
+	if (image == NULL || image->data == NULL || rop > SSD1306_ROP_XOR) {
 		return INVALID_PARAMS;
 	}
 
-	// Checks if pixels are inverted.
-	if (SSD1306.inverted) {
-		color = (SSD1306_color_t)!color;
-	}
+	int16_t w = image->width;
+	int16_t h = image->height;
 
-	// Sets color. Shifting right by 3 means dividing by 8. Bitwise ANDing by
-	// 0x7 means getting the remainder of a division by 8.
-	switch (color) {
-		case SSD1306_COLOR_WHITE:
-			SSD1306_Buffer[x + (y >> 3) * SSD1306_WIDTH] |= 1 << (y & 0x07);
-			break;
-		case SSD1306_COLOR_BLACK:
-			SSD1306_Buffer[x + (y >> 3) * SSD1306_WIDTH] &= ~(1 << (y & 0x07));
-			break;
-		default:
-			return INVALID_PARAMS;
+	// Visible columns of the image.
+	int16_t c0 = (x < SSD1306_Clip.x0) ? SSD1306_Clip.x0 - x : 0;
+	int16_t c1 = (x + w - 1 > SSD1306_Clip.x1) ? SSD1306_Clip.x1 - x : w - 1;
+
+	reader.src = image->data;
+	reader.compressed = image->compressed;
+
+	// Each image page is decoded into a row and drawn on its own, keeping
+	// only the visible columns. The data is read up to the last visible page.
+	for (int16_t top = 0; top < h && y + top <= SSD1306_Clip.y1; top += 8) {
+		for (int16_t c = 0; c < w; c++) {
+			uint8_t b = SSD1306_readImage(&reader);
+
+			if (c >= c0 && c <= c1) {
+				row[c - c0] = b;
+			}
+		}
+
+		if (c0 <= c1 && y + top + 7 >= SSD1306_Clip.y0) {
+			SSD1306_drawImage(x + c0, y + top, row, c1 - c0 + 1,
+				(h - top < 8) ? h - top : 8, rop);
+		}
 	}
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_drawBitmap(int16_t x, int16_t y,
-	const unsigned char* bitmap, int16_t w, int16_t h, SSD1306_color_t color) {
-
-    int16_t byteWidth = (w + 7) >> 3; // Bitmap scanline pad = whole byte
-    uint8_t byte = 0;
-
-    for(int16_t j=0; j<h; j++, y++) {
-        for(int16_t i=0; i<w; i++) {
-            if(i & 7) {
-               byte <<= 1;
-            }
-            else {
-               byte = (*(const unsigned char *)(&bitmap[j * byteWidth + i / 8]));
-            }
-            if(byte & 0x80) SSD1306_drawPixel(x+i, y, color);
-        }
-    }
+SSD1306_status_t SSD1306_sendImage(const SSD1306_image_t *image) {
+	SSD1306_imageReader_t reader = { 0 };
+	uint8_t cmd[8] = { 0x20, 0x00, 0x21, 0, SSD1306_LCD_WIDTH - 1, 0x22, 0,
+		SSD1306_MAX_PAGE_NUM - 1 };
+	uint16_t n = 1;
 
-    return LCD_OK;
-}
+	if (!SSD1306.initialized) {
+		return NO_INIT;
+	}
 
+	if (image == NULL || image->data == NULL ||
+		image->width != SSD1306_LCD_WIDTH ||
+		image->height != SSD1306_LCD_HEIGHT) {
 
-SSD1306_status_t SSD1306_gotoXY(uint16_t x, uint16_t y) {
-	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
 		return INVALID_PARAMS;
 	}
 
-	// Sets write pointers.
-	SSD1306.currentX = x;
-	SSD1306.currentY = y;
+	reader.src = image->data;
+	reader.compressed = image->compressed;
 
-	return LCD_OK;
-}
+	// Any incremental flush in progress is superseded.
+	SSD1306_Flush.active = 0;
 
+	// Horizontal addressing over the whole LCD: the address pointer wraps to
+	// the next page by itself, so the image is sent without any addressing.
+	SSD1306_status_t status = SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00,
+		cmd, sizeof(cmd));
 
-SSD1306_status_t SSD1306_putc(char ch, FontDef_t *font, SSD1306_color_t color) {
-	// Check available space on the visible LCD area.
-	if (SSD1306_WIDTH <= (SSD1306.currentX + font->fontWidth) ||
-		SSD1306_HEIGHT <= (SSD1306.currentY + font->fontHeight)) {
+	data_tmp[0] = 0x40;
 
-		return INVALID_PARAMS;
-	}
-	
-	for (uint8_t i = 0; i < font->fontHeight; i++) {
-		// Since the first available character of the ASCII table is 'space'
-		// (32d), subtracts it from the given char to compute the array index.
-		uint16_t b = font->data[(ch - 32) * font->fontHeight + i];
-
-		for (uint8_t j = 0; j < font->fontWidth; j++) {
-			if ((b << j) & 0x8000) {
-				SSD1306_drawPixel(SSD1306.currentX + j, (SSD1306.currentY + i),
-					color);
-			} else {
-				SSD1306_drawPixel(SSD1306.currentX + j, (SSD1306.currentY + i),
-					!color);
+	for (uint16_t i = 0; i < SSD1306_LCD_WIDTH * SSD1306_MAX_PAGE_NUM &&
+		status == LCD_OK; i++) {
+
+		data_tmp[n] = SSD1306_readImage(&reader);
+
+#if SSD1306_SHADOW_FLUSH
+		SSD1306_Shadow[i] = data_tmp[n];
+#endif
+
+		if (++n == SSD1306_I2C_DATATMP_SIZE ||
+			i == SSD1306_LCD_WIDTH * SSD1306_MAX_PAGE_NUM - 1) {
+
+			if (HAL_I2C_Master_Transmit(SSD1306.i2c_ptr, SSD1306_I2C_ADDR,
+				data_tmp, n, SSD1306_I2C_TIMEOUT) != HAL_OK) {
+
+				status = I2C_ERROR;
 			}
+
+			n = 1;
 		}
 	}
-	
-	// Updates the X pointer.
-	SSD1306.currentX += font->fontWidth;
-	
-	return LCD_OK;
-}
 
+	// Page addressing is restored even after a failed transfer, since the
+	// flushes rely on it.
+	cmd[1] = 0x02;
 
-SSD1306_status_t SSD1306_puts(char* str, FontDef_t *font, SSD1306_color_t color) {
-	while (*str) {
-		// Write character by character.
-		SSD1306_putc(*str, font, color);
-		str++;
+	SSD1306_status_t restore = SSD1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00,
+		cmd, 2);
+
+	if (status == LCD_OK) {
+		status = restore;
+	}
+
+	if (status != LCD_OK) {
+		SSD1306_SHADOW_INVALIDATE();
+		return status;
 	}
 
+#if SSD1306_SHADOW_FLUSH
+	// The shadow now holds the whole LCD RAM content.
+	SSD1306_ShadowValid = 1;
+	SSD1306_FlushStats.bytesSent += SSD1306_STRIP_SETUP_BYTES +
+		SSD1306_LCD_WIDTH * SSD1306_MAX_PAGE_NUM;
+#endif
+
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_putInt(int32_t num, uint8_t base, FontDef_t *font,
-	SSD1306_color_t color) {
+SSD1306_status_t SSD1306_drawGray(int16_t x, int16_t y, const uint8_t *gray,
+	int16_t w, int16_t h, SSD1306_dither_t dither) {
 
-	char buff[32];
+	uint8_t row[SSD1306_WIDTH];
+	// Error carried to the next row, one entry per visible column.
+	int16_t err[SSD1306_WIDTH + 1];
+
+	if (gray == NULL || w <= 0 || h <= 0 ||
+		dither > SSD1306_DITHER_FLOYD_STEINBERG) {
 
-	if (base < 2 || base > 32) {
 		return INVALID_PARAMS;
 	}
 
-	int32_t i = 0;
-	int32_t num_abs = ABS(num);
-	uint8_t is_negative = 0;
+	// Visible columns and image pages.
+	int16_t c0 = (x < SSD1306_Clip.x0) ? SSD1306_Clip.x0 - x : 0;
+	int16_t c1 = (x + w - 1 > SSD1306_Clip.x1) ? SSD1306_Clip.x1 - x : w - 1;
+	int16_t first = (y < SSD1306_Clip.y0) ? (SSD1306_Clip.y0 - y) & ~0x07 : 0;
 
-	if (num == 0) {
-		buff[0] = '0';
-		buff[1] = '\0';
-	} else {
-		if (num < 0 && base == 10) {
-			is_negative = 1;
-		}
+	if (c0 > c1) {
+		return LCD_OK;
+	}
 
-		// Processes individual digits.
-		while (num_abs) {
-			int32_t rem = num_abs % base;
-			buff[i++] = (rem > 9) ? (rem - 10) + 'A' : rem + '0';
-			num_abs /= base;
-		}
+	uint16_t n = c1 - c0 + 1;
 
-		if (is_negative)
-			buff[i++] = '-';
+	memset(err, 0, sizeof(err));
 
-		buff[i] = '\0';
+	for (int16_t top = first; top < h && y + top <= SSD1306_Clip.y1; top += 8) {
+		uint8_t rows = (h - top < 8) ? h - top : 8;
+		const uint8_t *src = &gray[top * w + c0];
 
-		// Inverts the buffer by swapping characters.
-		uint8_t start = 0;
-		uint8_t end = i - 1;
-		while (start < end) {
-			char c_tmp = buff[start];
-			buff[start] = buff[end];
-			buff[end] = c_tmp;
+		if (dither == SSD1306_DITHER_BAYER) {
+			// Each page byte is built at once from the 8 thresholds of its
+			// column, starting from the screen row of the image page.
+			uint8_t ty = (y + top) & 0x07;
 
-			start++;
-			end--;
-		}
-	}
+			for (uint16_t i = 0; i < n; i++) {
+				uint8_t tx = (x + c0 + i) & 0x07;
+				uint8_t b = 0;
 
-	char *buff_ptr = buff;
+				for (uint8_t r = 0; r < rows; r++) {
+					uint8_t t = SSD1306_BayerTable[(ty + r) & 0x07][tx];
 
-	// Prints the string of the converted integer.
-	while (*buff_ptr) {
-		// Write character by character.
-		SSD1306_putc(*buff_ptr, font, color);
-		buff_ptr++;
+					if (src[r * w + i] > t) {
+						b |= 1 << r;
+					}
+				}
+
+				row[i] = b;
+			}
+		} else {
+			memset(row, 0, n);
+
+			// Floyd-Steinberg, row by row: err[i + 1] holds the error of
+			// column i coming from the row above and is replaced by the
+			// error going to the row below once it has been read.
+			for (uint8_t r = 0; r < rows; r++) {
+				int16_t right = 0, carry = 0;
+
+				for (uint16_t i = 0; i < n; i++) {
+					int16_t v = src[r * w + i] + right + err[i + 1];
+					int16_t e = v;
+
+					if (v > 127) {
+						row[i] |= 1 << r;
+						e = v - 255;
+					}
+
+					right = (e * 7) / 16;
+					if (i > 0) {
+						err[i] += (e * 3) / 16;
+					}
+					err[i + 1] = (e * 5) / 16 + carry;
+					carry = e / 16;
+				}
+			}
+		}
+
+		SSD1306_drawImage(x + c0, y + top, row, n, rows, SSD1306_ROP_COPY);
 	}
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_drawLine(uint16_t x0, uint16_t y0, uint16_t x1,
-	uint16_t y1, SSD1306_color_t color) {
+SSD1306_status_t SSD1306_drawArc(int16_t x0, int16_t y0, int16_t r,
+	int16_t start_angle, int16_t end_angle, SSD1306_color_t color) {
 
-	int16_t dx, dy, sx, sy, err, e2, i, tmp;
-
-	if (x0 >= SSD1306_WIDTH) {
-		x0 = SSD1306_WIDTH - 1;
+	if (r < 0 || r > SSD1306_WIDTH) {
+		return INVALID_PARAMS;
 	}
 
-	if (x1 >= SSD1306_WIDTH) {
-		x1 = SSD1306_WIDTH - 1;
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
 	}
 
-	if (y0 >= SSD1306_HEIGHT) {
-		y0 = SSD1306_HEIGHT - 1;
-	}
+	int32_t r2 = (int32_t)r * r;
+	int32_t limit = r2 + r;
+	int32_t sx = SSD1306_cos(start_angle), sy = SSD1306_sin(start_angle);
+	int32_t ex = SSD1306_cos(end_angle), ey = SSD1306_sin(end_angle);
+	int16_t sweep = (end_angle - start_angle) % 360;
+	uint8_t full = (end_angle - start_angle >= 360);
+	int16_t dx = 0, prev = -1;
 
-	if (y1 >= SSD1306_HEIGHT) {
-		y1 = SSD1306_HEIGHT - 1;
+	if (sweep < 0) {
+		sweep += 360;
 	}
 
-	dx = (x0 < x1) ? (x1 - x0) : (x0 - x1);
-	dy = (y0 < y1) ? (y1 - y0) : (y0 - y1);
-	sx = (x0 < x1) ? 1 : -1;
-	sy = (y0 < y1) ? 1 : -1;
-
-	// Shifting by 1 means diving by two.
-	err = ((dx > dy) ? dx : -dy) >> 1;
-
-	// Draws vertical line.
-	if (dx == 0) {
-		if (y1 < y0) {
-			tmp = y1;
-			y1 = y0;
-			y0 = tmp;
+	for (int16_t dy = r; dy >= 0; dy--) {
+		while (dx < r && (int32_t)(dx + 1) * (dx + 1) + (int32_t)dy * dy <= limit) {
+			dx++;
 		}
 
-		if (x1 < x0) {
-			tmp = x1;
-			x0 = tmp;
+		// Same outline runs as @ref SSD1306_drawRoundShape, pixel by pixel.
+		int16_t from = (prev < 0) ? 0 : prev + 1;
+		if (from > dx) {
+			from = dx;
 		}
 
-		/* Vertical line */
-		for (i = y0; i <= y1; i++) {
-			SSD1306_drawPixel(x0, i, color);
+		for (int16_t k = from; k <= dx; k++) {
+			for (uint8_t q = 0; q < 4; q++) {
+				int16_t px = (q & 0x01) ? -k : k;
+				int16_t py = (q & 0x02) ? -dy : dy;
+
+				// Skips the mirrored copies of points on the axes.
+				if ((k == 0 && (q & 0x01)) || (dy == 0 && (q & 0x02))) {
+					continue;
+				}
+
+				// Cross products against the start and end directions.
+				uint8_t after_start = (sx * py - sy * px) >= 0;
+				uint8_t before_end = (px * ey - py * ex) >= 0;
+				uint8_t inside = full ||
+					((sweep <= 180) ? (after_start && before_end) :
+					(after_start || before_end));
+
+				if (inside) {
+					SSD1306_fillSpan(x0 + px, x0 + px, y0 + py, color);
+				}
+			}
 		}
 
-		/* Return from function */
-		return LCD_OK;
+		prev = dx;
 	}
 
-	// Draws horizontal line.
-	if (dy == 0) {
-		if (y1 < y0) {
-			tmp = y1;
-			y0 = tmp;
-		}
+	return LCD_OK;
+}
 
-		if (x1 < x0) {
-			tmp = x1;
-			x1 = x0;
-			x0 = tmp;
-		}
 
-		/* Horizontal line */
-		for (i = x0; i <= x1; i++) {
-			SSD1306_drawPixel(i, y0, color);
-		}
+SSD1306_status_t SSD1306_drawSector(int16_t x0, int16_t y0, int16_t r,
+	int16_t start_angle, int16_t end_angle, SSD1306_color_t color) {
 
-		/* Return from function */
-		return LCD_OK;
+	SSD1306_status_t status = SSD1306_drawArc(x0, y0, r, start_angle,
+		end_angle, color);
+
+	if (status != LCD_OK) {
+		return status;
 	}
 
-	while (1) {
-		SSD1306_drawPixel(x0, y0, color);
-		if (x0 == x1 && y0 == y1) {
-			break;
-		}
-		e2 = err;
-		if (e2 > -dx) {
-			err -= dy;
-			x0 += sx;
-		}
-		if (e2 < dy) {
-			err += dx;
-			y0 += sy;
-		}
+	// Checks if pixels are inverted.
+	if (SSD1306.inverted) {
+		color = (SSD1306_color_t)!color;
 	}
 
+	// Radii from the center to both ends of the arc, rounded to the nearest
+	// pixel (the sine table is scaled by 2^14).
+	SSD1306_plotLine(x0, y0,
+		x0 + (((int32_t)r * SSD1306_cos(start_angle) + 8192) >> 14),
+		y0 + (((int32_t)r * SSD1306_sin(start_angle) + 8192) >> 14), color);
+	SSD1306_plotLine(x0, y0,
+		x0 + (((int32_t)r * SSD1306_cos(end_angle) + 8192) >> 14),
+		y0 + (((int32_t)r * SSD1306_sin(end_angle) + 8192) >> 14), color);
+
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_drawRectangle(uint16_t x, uint16_t y, uint16_t w,
-	uint16_t h, SSD1306_color_t color) {
+#if SSD1306_BAND_RENDERING
 
-	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
-		return INVALID_PARAMS;
+SSD1306_status_t SSD1306_renderBands(SSD1306_drawCallback_t draw, void *ctx) {
+	if (!SSD1306.initialized) {
+		return NO_INIT;
 	}
 
-	/* Check width and height */
-	if ((x + w) >= SSD1306_WIDTH) {
-		w = SSD1306_WIDTH - x;
-	}
-	if ((y + h) >= SSD1306_HEIGHT) {
-		h = SSD1306_HEIGHT - y;
-	}
+	for (uint8_t m = 0; m < SSD1306_MAX_PAGE_NUM; m++) {
+		// Renders the page into the band buffer.
+		SSD1306_BandPage = m;
+		memset(SSD1306_Buffer, 0x00, SSD1306_WIDTH);
 
-	// Draws 4 lines.
-	SSD1306_drawLine(x, y, x + w, y, color);         /* Top line */
-	SSD1306_drawLine(x, y + h, x + w, y + h, color); /* Bottom line */
-	SSD1306_drawLine(x, y, x, y + h, color);         /* Left line */
-	SSD1306_drawLine(x + w, y, x + w, y + h, color); /* Right line */
+		if (draw != NULL) {
+			draw(ctx);
+		}
+
+		SSD1306_WRITECOMMAND(0xB0 + m);
+		SSD1306_WRITECOMMAND(0x00);
+		SSD1306_WRITECOMMAND(0x10);
+
+		// The band buffer already starts with the data control byte.
+		HAL_I2C_Master_Transmit(SSD1306.i2c_ptr, SSD1306_I2C_ADDR, SSD1306_Band,
+			SSD1306_BUFFER_MEMORY_SIZE, SSD1306_I2C_TIMEOUT);
+	}
 
 	return LCD_OK;
 }
 
+#endif
 
-SSD1306_status_t SSD1306_drawFilledRectangle(uint16_t x, uint16_t y, uint16_t w,
-	uint16_t h, SSD1306_color_t color) {
 
-	/* Check input parameters */
-	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
-		return INVALID_PARAMS;
-	}
+#if SSD1306_REGION_LOCKS
 
-	if ((x + w) >= SSD1306_WIDTH) {
-		w = SSD1306_WIDTH - x;
-	}
+SSD1306_status_t SSD1306_lockRegion(uint8_t start_page, uint8_t end_page,
+	uint8_t wait) {
 
-	if ((y + h) >= SSD1306_HEIGHT) {
-		h = SSD1306_HEIGHT - y;
+	if (start_page > end_page || end_page >= SSD1306_MAX_PAGE_NUM) {
+		return INVALID_PARAMS;
 	}
 
-	// Draws rectangle lines.
-	for (uint8_t i = 0; i <= h; i++) {
-		SSD1306_drawLine(x, y + i, x + w, y + i, color);
+	if (!wait) {
+		return SSD1306_tryLockPages(SSD1306_pageMask(start_page, end_page)) ?
+			LCD_OK : BUSY;
 	}
 
+	SSD1306_LOCK_PAGES(start_page, end_page);
+
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_drawTriangle(uint16_t x1, uint16_t y1, uint16_t x2,
-	uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_color_t color) {
+SSD1306_status_t SSD1306_unlockRegion(uint8_t start_page, uint8_t end_page) {
+	if (start_page > end_page || end_page >= SSD1306_MAX_PAGE_NUM) {
+		return INVALID_PARAMS;
+	}
 
-	SSD1306_drawLine(x1, y1, x2, y2, color);
-	SSD1306_drawLine(x2, y2, x3, y3, color);
-	SSD1306_drawLine(x3, y3, x1, y1, color);
+	SSD1306_UNLOCK_PAGES(start_page, end_page);
 
 	return LCD_OK;
 }
 
+#endif
 
-SSD1306_status_t SSD1306_drawFilledTriangle(uint16_t x1, uint16_t y1,
-	uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_color_t color) {
 
-	int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0,
-	yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0,
-	curpixel = 0;
+SSD1306_status_t SSD1306_sleep(void) {
+	SSD1306_WRITECOMMAND(0xAE);
 
-	deltax = ABS(x2 - x1);
-	deltay = ABS(y2 - y1);
-	x = x1;
-	y = y1;
+	return LCD_OK;
+}
 
-	if (x2 >= x1) {
-		xinc1 = 1;
-		xinc2 = 1;
-	} else {
-		xinc1 = -1;
-		xinc2 = -1;
-	}
 
-	if (y2 >= y1) {
-		yinc1 = 1;
-		yinc2 = 1;
-	} else {
-		yinc1 = -1;
-		yinc2 = -1;
-	}
+SSD1306_status_t SSD1306_wake(void) {
+	SSD1306_WRITECOMMAND(0xAF);
 
-	if (deltax >= deltay){
-		xinc1 = 0;
-		yinc2 = 0;
-		den = deltax;
-		num = deltax / 2;
-		numadd = deltay;
-		numpixels = deltax;
-	} else {
-		xinc2 = 0;
-		yinc1 = 0;
-		den = deltay;
-		num = deltay / 2;
-		numadd = deltax;
-		numpixels = deltay;
-	}
+	return LCD_OK;
+}
 
-	for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-		SSD1306_drawLine(x, y, x3, y3, color);
 
-		num += numadd;
-		if (num >= den) {
-			num -= den;
-			x += xinc1;
-			y += yinc1;
-		}
-		x += xinc2;
-		y += yinc2;
-	}
+SSD1306_status_t SSD1306_lcdOn(void) {
+	SSD1306_WRITECOMMAND(0x8D);  
+	SSD1306_WRITECOMMAND(0x14);  
+	SSD1306_WRITECOMMAND(0xAF);
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_drawCircle(int16_t x0, int16_t y0, int16_t r,
-	SSD1306_color_t color) {
-
-	int16_t f = 1 - r;
-	int16_t ddF_x = 1;
-	int16_t ddF_y = -2 * r;
-	int16_t x = 0;
-	int16_t y = r;
+SSD1306_status_t SSD1306_lcdOff(void) {
+	SSD1306_WRITECOMMAND(0x8D);  
+	SSD1306_WRITECOMMAND(0x10);
+	SSD1306_WRITECOMMAND(0xAE);
 
-    SSD1306_drawPixel(x0, y0 + r, color);
-    SSD1306_drawPixel(x0, y0 - r, color);
-    SSD1306_drawPixel(x0 + r, y0, color);
-    SSD1306_drawPixel(x0 - r, y0, color);
+	return LCD_OK;
+}
 
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
 
-        SSD1306_drawPixel(x0 + x, y0 + y, color);
-        SSD1306_drawPixel(x0 - x, y0 + y, color);
-        SSD1306_drawPixel(x0 + x, y0 - y, color);
-        SSD1306_drawPixel(x0 - x, y0 - y, color);
+#if SSD1306_SHADOW_FLUSH
 
-        SSD1306_drawPixel(x0 + y, y0 + x, color);
-        SSD1306_drawPixel(x0 - y, y0 + x, color);
-        SSD1306_drawPixel(x0 + y, y0 - x, color);
-        SSD1306_drawPixel(x0 - y, y0 - x, color);
-    }
+SSD1306_status_t SSD1306_invalidateShadow(void) {
+	SSD1306_SHADOW_INVALIDATE();
 
-    return LCD_OK;
+	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_drawFilledCircle(int16_t x0, int16_t y0, int16_t r,
-	SSD1306_color_t color) {
-
-	int16_t f = 1 - r;
-	int16_t ddF_x = 1;
-	int16_t ddF_y = -2 * r;
-	int16_t x = 0;
-	int16_t y = r;
+SSD1306_status_t SSD1306_getFlushStats(SSD1306_flushStats_t *stats) {
+	if (stats == NULL) {
+		return INVALID_PARAMS;
+	}
 
-    SSD1306_drawPixel(x0, y0 + r, color);
-    SSD1306_drawPixel(x0, y0 - r, color);
-    SSD1306_drawPixel(x0 + r, y0, color);
-    SSD1306_drawPixel(x0 - r, y0, color);
-    SSD1306_drawLine(x0 - r, y0, x0 + r, y0, color);
+	*stats = SSD1306_FlushStats;
 
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+	return LCD_OK;
+}
 
-        SSD1306_drawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-        SSD1306_drawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
 
-        SSD1306_drawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-        SSD1306_drawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
-    }
+SSD1306_status_t SSD1306_resetFlushStats(void) {
+	memset(&SSD1306_FlushStats, 0, sizeof(SSD1306_FlushStats));
 
-    return LCD_OK;
+	return LCD_OK;
 }
 
+#endif
 
-SSD1306_status_t SSD1306_lcdOn(void) {
-	SSD1306_WRITECOMMAND(0x8D);  
-	SSD1306_WRITECOMMAND(0x14);  
-	SSD1306_WRITECOMMAND(0xAF);
+
+#if SSD1306_GLYPH_CACHE_SIZE > 0
+
+SSD1306_status_t SSD1306_getGlyphCacheStats(SSD1306_glyphCacheStats_t *stats) {
+	if (stats == NULL) {
+		return INVALID_PARAMS;
+	}
+
+	*stats = SSD1306_GlyphCacheStats;
 
 	return LCD_OK;
 }
 
 
-SSD1306_status_t SSD1306_lcdOff(void) {
-	SSD1306_WRITECOMMAND(0x8D);  
-	SSD1306_WRITECOMMAND(0x10);
-	SSD1306_WRITECOMMAND(0xAE);
+SSD1306_status_t SSD1306_resetGlyphCache(void) {
+	memset(SSD1306_GlyphCache, 0, sizeof(SSD1306_GlyphCache));
+	memset(&SSD1306_GlyphCacheStats, 0, sizeof(SSD1306_GlyphCacheStats));
 
 	return LCD_OK;
 }
 
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // I2C COMMUNICATION FUNCTIONS.
 ///////////////////////////////////////////////////////////////////////////////
 
-/**
- * @brief Temporary buffer to store data to be transmitted to the LCD.
- */
-static uint8_t data_tmp[SSD1306_I2C_DATATMP_SIZE];
-
+SSD1306_status_t SSD1306_I2C_WriteMulti(uint8_t addr, uint8_t reg,
+	uint8_t* data, uint16_t count) {
 
-void SSD1306_I2C_WriteMulti(uint8_t addr, uint8_t reg, uint8_t* data,
-	uint16_t count) {
+	// Avoids buffer overflow: the register byte takes the first slot.
+	if (count >= SSD1306_I2C_DATATMP_SIZE) {
+		return INVALID_PARAMS;
+	}
 
-	// Avoids buffer overflow.
-	if (count > SSD1306_I2C_DATATMP_SIZE) {
-		return;
+#if SSD1306_EXTERNAL_MEMORY
+	if (data_tmp == NULL) {
+		return NO_INIT;
 	}
+#endif
 
 	data_tmp[0] = reg;
 
 	memcpy(data_tmp + 1, data, count);
 
-	HAL_I2C_Master_Transmit(SSD1306.i2c_ptr, addr, data_tmp, count + 1,
-		SSD1306_I2C_TIMEOUT);
+	if (HAL_I2C_Master_Transmit(SSD1306.i2c_ptr, addr, data_tmp, count + 1,
+		SSD1306_I2C_TIMEOUT) != HAL_OK) {
+
+		return I2C_ERROR;
+	}
 
-	return;
+	return LCD_OK;
 }
 
 
-void SSD1306_I2C_Write(uint8_t addr, uint8_t reg, uint8_t data) {
+SSD1306_status_t SSD1306_I2C_Write(uint8_t addr, uint8_t reg, uint8_t data) {
+#if SSD1306_EXTERNAL_MEMORY
+	if (data_tmp == NULL) {
+		return NO_INIT;
+	}
+#endif
+
 	data_tmp[0] = reg;
 	data_tmp[1] = data;
 
-	HAL_I2C_Master_Transmit(SSD1306.i2c_ptr, addr, data_tmp, 2,
-		SSD1306_I2C_TIMEOUT);
+	if (HAL_I2C_Master_Transmit(SSD1306.i2c_ptr, addr, data_tmp, 2,
+		SSD1306_I2C_TIMEOUT) != HAL_OK) {
+
+		return I2C_ERROR;
+	}
 
-	return;
+	return LCD_OK;
 }
@@ -0,0 +1,173 @@
+/**
+ * @file   ssd1306_anim.c
+ * @brief  Animation player of SSD1306 driver module for STM32f10x and
+ *         STM32F4xx.
+ *
+ * 		   Frames are read straight from the animation data, usually in
+ * 		   flash: keyframes are decoded while drawing and delta frames are
+ * 		   copied span by span, so no frame is ever held in RAM besides the
+ * 		   driver buffer.
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include "ssd1306_anim.h"
+
+
+/* Frame types and end of spans marker. */
+#define SSD1306_ANIM_KEYFRAME 0x00
+#define SSD1306_ANIM_DELTA    0x01
+#define SSD1306_ANIM_END      0xFF
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Reads a 16-bit little endian value.
+ */
+static inline uint16_t SSD1306_read16(const uint8_t *p) {
+	return p[0] | (p[1] << 8);
+}
+
+
+/**
+ * @brief Draws a frame and sends the changed area to the LCD.
+ * @retval Pointer to the data of the following frame.
+ */
+static const uint8_t *SSD1306_showFrame(const SSD1306_animPlayer_t *player,
+	const uint8_t *p, SSD1306_status_t *status) {
+
+	const SSD1306_animation_t *anim = player->anim;
+	uint8_t type = p[0];
+
+	// Skips the type and the duration.
+	p += 3;
+
+	if (type == SSD1306_ANIM_KEYFRAME) {
+		SSD1306_image_t frame = { anim->width, anim->height, 1, p + 2 };
+
+		SSD1306_drawPackedImage(player->x, player->y, &frame,
+			SSD1306_ROP_COPY);
+		*status = SSD1306_updateArea(player->x, player->y, anim->width,
+			anim->height);
+
+		return p + 2 + SSD1306_read16(p);
+	}
+
+	*status = LCD_OK;
+
+	// Each span is copied into the buffer and sent on its own, so unchanged
+	// bytes never go on the bus.
+	while (p[0] != SSD1306_ANIM_END) {
+		int16_t top = p[0] * 8;
+		int16_t h = (anim->height - top < 8) ? anim->height - top : 8;
+		int16_t x = player->x + p[1];
+		int16_t y = player->y + top;
+		uint8_t n = p[2];
+
+		SSD1306_drawImage(x, y, p + 3, n, h, SSD1306_ROP_COPY);
+
+		if (*status == LCD_OK) {
+			*status = SSD1306_updateArea(x, y, n, h);
+		}
+
+		p += 3 + n;
+	}
+
+	return p + 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS.
+///////////////////////////////////////////////////////////////////////////////
+
+SSD1306_status_t SSD1306_initAnimPlayer(SSD1306_animPlayer_t *player,
+	const SSD1306_animation_t *anim, int16_t x, int16_t y, uint8_t loop) {
+
+	if (player == NULL || anim == NULL || anim->data == NULL ||
+		anim->frameCount == 0) {
+
+		return INVALID_PARAMS;
+	}
+
+#if SSD1306_BAND_RENDERING
+	// Delta frames need the previous frame in the buffer.
+	(void)x;
+	(void)y;
+	(void)loop;
+	return INVALID_PARAMS;
+#else
+	if (x < 0 || y < 0 || x + anim->width > SSD1306_WIDTH ||
+		y + anim->height > SSD1306_HEIGHT) {
+
+		return INVALID_PARAMS;
+	}
+
+	player->anim = anim;
+	player->x = x;
+	player->y = y;
+	player->loop = loop;
+	player->started = 0;
+	player->frame = 0;
+	player->next = anim->data;
+	player->due = 0;
+
+	return LCD_OK;
+#endif
+}
+
+
+SSD1306_status_t SSD1306_animStep(SSD1306_animPlayer_t *player, uint32_t now,
+	uint8_t *done) {
+
+	SSD1306_status_t status;
+
+	if (player == NULL || player->anim == NULL || done == NULL) {
+		return INVALID_PARAMS;
+	}
+
+	*done = (player->frame == player->anim->frameCount);
+
+	if (*done || (player->started && (int32_t)(now - player->due) < 0)) {
+		return LCD_OK;
+	}
+
+	uint16_t duration = SSD1306_read16(player->next + 1);
+
+	player->next = SSD1306_showFrame(player, player->next, &status);
+
+	// Frames keep their pace unless one is more than its duration late.
+	if (!player->started || now - player->due > duration) {
+		player->due = now + duration;
+	} else {
+		player->due += duration;
+	}
+
+	player->started = 1;
+
+	if (++player->frame == player->anim->frameCount) {
+		if (player->loop) {
+			player->frame = 0;
+			player->next = player->anim->data;
+		} else {
+			*done = 1;
+		}
+	}
+
+	return status;
+}
@@ -0,0 +1,404 @@
+/**
+ * @file   ssd1306_dlist.c
+ * @brief  Retained display list of SSD1306 driver module for STM32f10x and
+ *         STM32F4xx.
+ *
+ * 		   The display list keeps the primitives shown on the LCD. Each item
+ * 		   has a stable ID; adding, changing or removing an item marks the
+ * 		   areas it covered and covers as damaged, and only those areas are
+ * 		   redrawn and sent to the LCD on the next flush.
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include "ssd1306_dlist.h"
+
+
+/**
+ * @brief Rectangle with inclusive bounds.
+ */
+typedef struct {
+	int16_t x0, y0, x1, y1;
+} SSD1306_box_t;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Private display list. The index of an item is its ID.
+ */
+static SSD1306_item_t SSD1306_Items[SSD1306_DLIST_MAX_ITEMS];
+
+/**
+ * @brief IDs of the items in stacking order, from the bottom one to the top
+ *        one. IDs are reused, so the stacking order is kept apart from them.
+ */
+static uint8_t SSD1306_Order[SSD1306_DLIST_MAX_ITEMS];
+
+/**
+ * @brief Number of items in the display list.
+ */
+static uint8_t SSD1306_ItemCount;
+
+/**
+ * @brief Private list of damaged areas.
+ */
+static SSD1306_box_t SSD1306_Damage[SSD1306_DLIST_MAX_DAMAGE];
+
+/**
+ * @brief Number of damaged areas.
+ */
+static uint8_t SSD1306_DamageCount;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Computes the area covered by an item, clipped to the visible area.
+ * @retval 0 if the item is not visible at all, 1 otherwise.
+ */
+static uint8_t SSD1306_itemBox(const SSD1306_item_t *item, SSD1306_box_t *box) {
+	switch (item->type) {
+		case SSD1306_ITEM_RECT:
+		case SSD1306_ITEM_FILLED_RECT:
+		case SSD1306_ITEM_BITMAP:
+			box->x0 = item->x;
+			box->y0 = item->y;
+			box->x1 = item->x + item->w - 1;
+			box->y1 = item->y + item->h - 1;
+			break;
+		case SSD1306_ITEM_LINE:
+			box->x0 = (item->x < item->w) ? item->x : item->w;
+			box->x1 = (item->x < item->w) ? item->w : item->x;
+			box->y0 = (item->y < item->h) ? item->y : item->h;
+			box->y1 = (item->y < item->h) ? item->h : item->y;
+			break;
+		case SSD1306_ITEM_CIRCLE:
+		case SSD1306_ITEM_FILLED_CIRCLE:
+			box->x0 = item->x - item->w;
+			box->y0 = item->y - item->w;
+			box->x1 = item->x + item->w;
+			box->y1 = item->y + item->w;
+			break;
+		case SSD1306_ITEM_TEXT: {
+			FontStringSize_t size;
+
+			if (item->data == NULL || item->font == NULL) {
+				return 0;
+			}
+			get_string_size((char *)item->data, &size, item->font);
+			box->x0 = item->x;
+			box->y0 = item->y;
+			box->x1 = item->x + size.length - 1;
+			box->y1 = item->y + size.height - 1;
+			break;
+		}
+		default:
+			return 0;
+	}
+
+	if (box->x0 < 0) box->x0 = 0;
+	if (box->y0 < 0) box->y0 = 0;
+	if (box->x1 >= SSD1306_WIDTH) box->x1 = SSD1306_WIDTH - 1;
+	if (box->y1 >= SSD1306_HEIGHT) box->y1 = SSD1306_HEIGHT - 1;
+
+	return (box->x0 <= box->x1 && box->y0 <= box->y1);
+}
+
+
+/**
+ * @brief Returns the area of the smallest box containing both boxes.
+ */
+static int32_t SSD1306_unionArea(const SSD1306_box_t *a, const SSD1306_box_t *b) {
+	int32_t w = ((a->x1 > b->x1) ? a->x1 : b->x1) -
+		((a->x0 < b->x0) ? a->x0 : b->x0) + 1;
+	int32_t h = ((a->y1 > b->y1) ? a->y1 : b->y1) -
+		((a->y0 < b->y0) ? a->y0 : b->y0) + 1;
+
+	return w * h;
+}
+
+
+/**
+ * @brief Grows box a to contain box b.
+ */
+static void SSD1306_unionBox(SSD1306_box_t *a, const SSD1306_box_t *b) {
+	if (b->x0 < a->x0) a->x0 = b->x0;
+	if (b->y0 < a->y0) a->y0 = b->y0;
+	if (b->x1 > a->x1) a->x1 = b->x1;
+	if (b->y1 > a->y1) a->y1 = b->y1;
+}
+
+
+/**
+ * @brief Returns 1 if the two boxes overlap.
+ */
+static uint8_t SSD1306_overlaps(const SSD1306_box_t *a, const SSD1306_box_t *b) {
+	return a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1;
+}
+
+
+/**
+ * @brief Adds an area to the damage list. An area overlapping an existing
+ *        one is merged into it. When the list is full, the area is merged
+ *        with the one whose bounding box grows the least.
+ */
+static void SSD1306_addDamage(const SSD1306_box_t *box) {
+	uint8_t best = 0;
+	int32_t best_growth = INT32_MAX;
+
+	for (uint8_t i = 0; i < SSD1306_DamageCount; i++) {
+		SSD1306_box_t *d = &SSD1306_Damage[i];
+
+		if (SSD1306_overlaps(d, box)) {
+			SSD1306_unionBox(d, box);
+			return;
+		}
+
+		int32_t growth = SSD1306_unionArea(d, box) -
+			(int32_t)(d->x1 - d->x0 + 1) * (d->y1 - d->y0 + 1);
+
+		if (growth < best_growth) {
+			best_growth = growth;
+			best = i;
+		}
+	}
+
+	if (SSD1306_DamageCount < SSD1306_DLIST_MAX_DAMAGE) {
+		SSD1306_Damage[SSD1306_DamageCount++] = *box;
+	} else {
+		SSD1306_unionBox(&SSD1306_Damage[best], box);
+	}
+}
+
+
+/**
+ * @brief Marks the area covered by an item as damaged.
+ */
+static void SSD1306_damageItem(const SSD1306_item_t *item) {
+	SSD1306_box_t box;
+
+	if (SSD1306_itemBox(item, &box)) {
+		SSD1306_addDamage(&box);
+	}
+}
+
+
+/**
+ * @brief Removes an ID from the stacking order, moving the items above it
+ *        down by one.
+ */
+static void SSD1306_unstack(uint8_t id) {
+	uint8_t i = 0;
+
+	while (SSD1306_Order[i] != id) {
+		i++;
+	}
+
+	for (SSD1306_ItemCount--; i < SSD1306_ItemCount; i++) {
+		SSD1306_Order[i] = SSD1306_Order[i + 1];
+	}
+}
+
+
+/**
+ * @brief Draws an item into the driver buffer.
+ */
+static void SSD1306_drawItem(const SSD1306_item_t *item) {
+	switch (item->type) {
+		case SSD1306_ITEM_RECT:
+			SSD1306_drawRoundRect(item->x, item->y, item->w, item->h, 0,
+				item->color);
+			break;
+		case SSD1306_ITEM_FILLED_RECT:
+			SSD1306_drawFilledRoundRect(item->x, item->y, item->w, item->h, 0,
+				item->color);
+			break;
+		case SSD1306_ITEM_LINE:
+			SSD1306_drawLine(item->x, item->y, item->w, item->h, item->color);
+			break;
+		case SSD1306_ITEM_CIRCLE:
+			SSD1306_drawCircle(item->x, item->y, item->w, item->color);
+			break;
+		case SSD1306_ITEM_FILLED_CIRCLE:
+			SSD1306_drawFilledCircle(item->x, item->y, item->w, item->color);
+			break;
+		case SSD1306_ITEM_TEXT:
+			if (SSD1306_gotoXY(item->x, item->y) == LCD_OK) {
+				SSD1306_putsMode((char *)item->data, item->font, item->color,
+					SSD1306_TEXT_TRANSPARENT);
+			}
+			break;
+		case SSD1306_ITEM_BITMAP:
+			SSD1306_drawBitmap(item->x, item->y, item->data, item->w, item->h,
+				item->color);
+			break;
+		default:
+			break;
+	}
+}
+
+
+#if SSD1306_BAND_RENDERING
+
+/**
+ * @brief Band rendering callback drawing every item.
+ */
+static void SSD1306_drawAll(void *ctx) {
+	(void)ctx;
+
+	for (uint8_t i = 0; i < SSD1306_ItemCount; i++) {
+		SSD1306_drawItem(&SSD1306_Items[SSD1306_Order[i]]);
+	}
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS.
+///////////////////////////////////////////////////////////////////////////////
+
+SSD1306_status_t SSD1306_dlistInit(void) {
+	SSD1306_box_t screen = { 0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1 };
+
+	memset(SSD1306_Items, 0, sizeof(SSD1306_Items));
+	SSD1306_ItemCount = 0;
+
+	SSD1306_DamageCount = 0;
+	SSD1306_addDamage(&screen);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_dlistAdd(const SSD1306_item_t *item, uint8_t *id) {
+	if (item == NULL || id == NULL || item->type == SSD1306_ITEM_NONE) {
+		return INVALID_PARAMS;
+	}
+
+	for (uint8_t i = 0; i < SSD1306_DLIST_MAX_ITEMS; i++) {
+		if (SSD1306_Items[i].type == SSD1306_ITEM_NONE) {
+			SSD1306_Items[i] = *item;
+			SSD1306_Order[SSD1306_ItemCount++] = i;
+			SSD1306_damageItem(item);
+			*id = i;
+
+			return LCD_OK;
+		}
+	}
+
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_dlistUpdate(uint8_t id, const SSD1306_item_t *item) {
+	if (item == NULL || id >= SSD1306_DLIST_MAX_ITEMS ||
+		SSD1306_Items[id].type == SSD1306_ITEM_NONE ||
+		item->type == SSD1306_ITEM_NONE) {
+
+		return INVALID_PARAMS;
+	}
+
+	// Both where the item was and where it is now must be redrawn.
+	SSD1306_damageItem(&SSD1306_Items[id]);
+	SSD1306_Items[id] = *item;
+	SSD1306_damageItem(item);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_dlistRemove(uint8_t id) {
+	if (id >= SSD1306_DLIST_MAX_ITEMS ||
+		SSD1306_Items[id].type == SSD1306_ITEM_NONE) {
+
+		return INVALID_PARAMS;
+	}
+
+	SSD1306_damageItem(&SSD1306_Items[id]);
+	SSD1306_Items[id].type = SSD1306_ITEM_NONE;
+	SSD1306_unstack(id);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_dlistRaise(uint8_t id) {
+	if (id >= SSD1306_DLIST_MAX_ITEMS ||
+		SSD1306_Items[id].type == SSD1306_ITEM_NONE) {
+
+		return INVALID_PARAMS;
+	}
+
+	// The item may now hide parts of the items it was below.
+	SSD1306_unstack(id);
+	SSD1306_Order[SSD1306_ItemCount++] = id;
+	SSD1306_damageItem(&SSD1306_Items[id]);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_dlistFlush(void) {
+	SSD1306_status_t status = LCD_OK;
+
+	if (SSD1306_DamageCount == 0) {
+		return LCD_OK;
+	}
+
+#if SSD1306_BAND_RENDERING
+	// Without a full frame in RAM, the whole screen is rendered again.
+	status = SSD1306_renderBands(SSD1306_drawAll, NULL);
+#else
+	for (uint8_t d = 0; d < SSD1306_DamageCount; d++) {
+		SSD1306_box_t *box = &SSD1306_Damage[d];
+		int16_t w = box->x1 - box->x0 + 1;
+		int16_t h = box->y1 - box->y0 + 1;
+
+		SSD1306_setClipRect(box->x0, box->y0, w, h);
+		SSD1306_drawFilledRoundRect(box->x0, box->y0, w, h, 0,
+			SSD1306_COLOR_BLACK);
+
+		for (uint8_t i = 0; i < SSD1306_ItemCount; i++) {
+			const SSD1306_item_t *item = &SSD1306_Items[SSD1306_Order[i]];
+			SSD1306_box_t item_box;
+
+			if (SSD1306_itemBox(item, &item_box) &&
+				SSD1306_overlaps(&item_box, box)) {
+
+				SSD1306_drawItem(item);
+			}
+		}
+
+		SSD1306_resetClipRect();
+
+		status = SSD1306_updateArea(box->x0, box->y0, w, h);
+		if (status != LCD_OK) {
+			break;
+		}
+	}
+#endif
+
+	if (status == LCD_OK) {
+		SSD1306_DamageCount = 0;
+	}
+
+	return status;
+}
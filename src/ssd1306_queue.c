@@ -0,0 +1,247 @@
+/**
+ * @file   ssd1306_queue.c
+ * @brief  Draw command queue of SSD1306 driver module for STM32f10x and
+ *         STM32F4xx.
+ *
+ * 		   The queue is a bounded ring where each slot carries a sequence
+ * 		   number. A producer claims a slot by advancing the tail with a
+ * 		   compare-and-swap, copies its command and publishes it by storing
+ * 		   the sequence number; the consumer only takes slots that have been
+ * 		   published. Producers never wait on each other, so the queue can be
+ * 		   used from interrupt handlers too.
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <stdatomic.h>
+
+#include "ssd1306_queue.h"
+
+
+/**
+ * @brief Queue slot. The sequence number equals the position the slot is
+ *        free for, or that position + 1 once the command is published.
+ */
+typedef struct {
+	atomic_uint   seq;
+	SSD1306_cmd_t cmd;
+} SSD1306_slot_t;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Private command ring.
+ */
+static SSD1306_slot_t SSD1306_Queue[SSD1306_QUEUE_SIZE];
+
+/**
+ * @brief Position of the next slot to be claimed by producers.
+ */
+static atomic_uint SSD1306_QueueTail;
+
+/**
+ * @brief Position of the next slot to be run. Only the consumer uses it.
+ */
+static unsigned int SSD1306_QueueHead;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Runs a command on the driver.
+ */
+static SSD1306_status_t SSD1306_runCmd(const SSD1306_cmd_t *cmd) {
+	switch (cmd->type) {
+		case SSD1306_CMD_FILL:
+			return SSD1306_fill(cmd->color);
+		case SSD1306_CMD_PIXEL:
+			if (cmd->x < 0 || cmd->y < 0) {
+				return INVALID_PARAMS;
+			}
+			return SSD1306_drawPixel(cmd->x, cmd->y, cmd->color);
+		case SSD1306_CMD_LINE:
+			return SSD1306_drawLine(cmd->x, cmd->y, cmd->w, cmd->h, cmd->color);
+		case SSD1306_CMD_RECT:
+			return SSD1306_drawRoundRect(cmd->x, cmd->y, cmd->w, cmd->h, 0,
+				cmd->color);
+		case SSD1306_CMD_FILLED_RECT:
+			return SSD1306_drawFilledRoundRect(cmd->x, cmd->y, cmd->w, cmd->h, 0,
+				cmd->color);
+		case SSD1306_CMD_CIRCLE:
+			return SSD1306_drawCircle(cmd->x, cmd->y, cmd->w, cmd->color);
+		case SSD1306_CMD_FILLED_CIRCLE:
+			return SSD1306_drawFilledCircle(cmd->x, cmd->y, cmd->w, cmd->color);
+		case SSD1306_CMD_TEXT:
+			if (cmd->x < 0 || cmd->y < 0 ||
+				SSD1306_gotoXY(cmd->x, cmd->y) != LCD_OK) {
+
+				return INVALID_PARAMS;
+			}
+			return SSD1306_puts((char *)cmd->text, cmd->font, cmd->color);
+		case SSD1306_CMD_BITMAP:
+			return SSD1306_drawBitmap(cmd->x, cmd->y, cmd->bitmap, cmd->w, cmd->h,
+				cmd->color);
+		case SSD1306_CMD_UPDATE_AREA:
+			if (cmd->x < 0 || cmd->y < 0 || cmd->w <= 0 || cmd->h <= 0) {
+				return INVALID_PARAMS;
+			}
+			return SSD1306_updateArea(cmd->x, cmd->y, cmd->w, cmd->h);
+		case SSD1306_CMD_UPDATE_SCREEN:
+			return SSD1306_updateScreen();
+		default:
+			return INVALID_PARAMS;
+	}
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FUNCTION DEFINITIONS.
+///////////////////////////////////////////////////////////////////////////////
+
+SSD1306_status_t SSD1306_queueInit(void) {
+	for (unsigned int i = 0; i < SSD1306_QUEUE_SIZE; i++) {
+		atomic_init(&SSD1306_Queue[i].seq, i);
+	}
+
+	atomic_init(&SSD1306_QueueTail, 0);
+	SSD1306_QueueHead = 0;
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_queuePost(const SSD1306_cmd_t *cmd) {
+	SSD1306_slot_t *slot;
+	unsigned int pos;
+
+	if (cmd == NULL) {
+		return INVALID_PARAMS;
+	}
+
+	pos = atomic_load_explicit(&SSD1306_QueueTail, memory_order_relaxed);
+
+	for (;;) {
+		slot = &SSD1306_Queue[pos & (SSD1306_QUEUE_SIZE - 1)];
+
+		int diff = (int)(atomic_load_explicit(&slot->seq, memory_order_acquire)
+			- pos);
+
+		if (diff == 0) {
+			// The slot is free: claims it, unless another producer did first.
+			if (atomic_compare_exchange_weak_explicit(&SSD1306_QueueTail, &pos,
+				pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			// The slot still holds a command not yet run.
+			return BUSY;
+		} else {
+			pos = atomic_load_explicit(&SSD1306_QueueTail, memory_order_relaxed);
+		}
+	}
+
+	slot->cmd = *cmd;
+	atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_queuePuts(SSD1306_point_t *cursor, const char *str,
+	FontDef_t *font, SSD1306_color_t color) {
+
+	SSD1306_cmd_t cmd;
+
+	if (cursor == NULL || str == NULL || font == NULL) {
+		return INVALID_PARAMS;
+	}
+
+	cmd.type = SSD1306_CMD_TEXT;
+	cmd.color = color;
+	cmd.font = font;
+	cmd.bitmap = NULL;
+	cmd.w = cmd.h = 0;
+
+	while (*str) {
+		FontStringSize_t size;
+		uint8_t n = 0;
+
+		while (str[n] && n < SSD1306_QUEUE_TEXT_LEN - 1) {
+			cmd.text[n] = str[n];
+			n++;
+		}
+
+		// Does not split a UTF-8 sequence between two commands.
+		if (str[n]) {
+			while (n > 1 && ((uint8_t)str[n] & 0xC0) == 0x80) {
+				n--;
+			}
+		}
+		cmd.text[n] = '\0';
+		cmd.x = cursor->x;
+		cmd.y = cursor->y;
+
+		if (SSD1306_queuePost(&cmd) != LCD_OK) {
+			return BUSY;
+		}
+
+		get_string_size(cmd.text, &size, font);
+		cursor->x += size.length;
+		str += n;
+	}
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_queueProcess(uint16_t max_cmds, uint16_t *count) {
+	SSD1306_status_t status = LCD_OK;
+	uint16_t n = 0;
+
+	while (max_cmds == 0 || n < max_cmds) {
+		SSD1306_slot_t *slot =
+			&SSD1306_Queue[SSD1306_QueueHead & (SSD1306_QUEUE_SIZE - 1)];
+		SSD1306_cmd_t cmd;
+
+		if (atomic_load_explicit(&slot->seq, memory_order_acquire) !=
+			SSD1306_QueueHead + 1) {
+			break;
+		}
+
+		// Copies the command out, so that the slot is handed back to the
+		// producers before drawing.
+		cmd = slot->cmd;
+		atomic_store_explicit(&slot->seq, SSD1306_QueueHead + SSD1306_QUEUE_SIZE,
+			memory_order_release);
+		SSD1306_QueueHead++;
+
+		SSD1306_status_t cmd_status = SSD1306_runCmd(&cmd);
+		if (cmd_status != LCD_OK) {
+			status = cmd_status;
+		}
+		n++;
+	}
+
+	if (count != NULL) {
+		*count = n;
+	}
+
+	return status;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file   image_roundtrip.c
+ * @brief  Host test of the image path: a PBM image converted and compressed
+ *         by ssd1306_img, then drawn with SSD1306_drawPackedImage or sent
+ *         with SSD1306_sendImage, must show on the emulated LCD exactly as
+ *         in the PBM file.
+ *
+ * 		   Build and run from the repository root:
+ * 		   cc -O2 -o ssd1306_img tools/ssd1306_img.c
+ * 		   ./ssd1306_img -c -n roundtrip tests/roundtrip.pbm > roundtrip.c
+ * 		   cc -O2 -std=c99 -Iinc -Itools/host tests/image_roundtrip.c
+ * 		      roundtrip.c tools/host/host_hal.c src/ssd1306.c src/fonts.c
+ * 		      -o image_roundtrip
+ * 		   ./image_roundtrip tests/roundtrip.pbm
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include "host_hal.h"
+#include "ssd1306.h"
+
+
+/**
+ * @brief Image generated by ssd1306_img from the PBM file.
+ */
+extern const SSD1306_image_t roundtrip;
+
+
+static I2C_HandleTypeDef Hi2c;
+
+/**
+ * @brief Pixels of the PBM file, 1 for set (black) pixels.
+ */
+static uint8_t Pbm[SSD1306_LCD_HEIGHT][SSD1306_LCD_WIDTH];
+
+
+/**
+ * @brief Reads the next PBM token character, skipping white space and
+ *        comments.
+ */
+static int nextChar(FILE *f) {
+	int c;
+
+	while ((c = fgetc(f)) != EOF) {
+		if (c == '#') {
+			while ((c = fgetc(f)) != EOF && c != '\n');
+		} else if (!isspace(c)) {
+			break;
+		}
+	}
+
+	return c;
+}
+
+
+/**
+ * @brief Reads the next PBM header number.
+ * @retval The number, or -1 on error.
+ */
+static int nextNum(FILE *f) {
+	int c = nextChar(f), n;
+
+	if (c == EOF || ungetc(c, f) == EOF || fscanf(f, "%d", &n) != 1) {
+		return -1;
+	}
+
+	return n;
+}
+
+
+/**
+ * @brief Reads a plain (P1) PBM file of the LCD size.
+ * @retval 0 on success, -1 on error.
+ */
+static int readPbm(const char *path) {
+	FILE *f = fopen(path, "r");
+	int w = 0, h = 0, status = 0;
+
+	if (f == NULL) {
+		perror(path);
+		return -1;
+	}
+
+	if (nextChar(f) != 'P' || fgetc(f) != '1' ||
+		(w = nextNum(f)) != SSD1306_LCD_WIDTH ||
+		(h = nextNum(f)) != SSD1306_LCD_HEIGHT) {
+
+		status = -1;
+	}
+
+	for (int y = 0; y < h && status == 0; y++) {
+		for (int x = 0; x < w && status == 0; x++) {
+			int c = nextChar(f);
+
+			if (c != '0' && c != '1') {
+				status = -1;
+			}
+
+			Pbm[y][x] = (c == '1');
+		}
+	}
+
+	fclose(f);
+
+	if (status != 0) {
+		fprintf(stderr, "%s: not a %dx%d plain PBM image\n", path,
+			SSD1306_LCD_WIDTH, SSD1306_LCD_HEIGHT);
+	}
+
+	return status;
+}
+
+
+/**
+ * @brief Compares the emulated LCD with the PBM image moved by (dx, dy),
+ *        pixels outside the image being off.
+ * @retval Number of pixels that differ.
+ */
+static int compare(const char *name, int dx, int dy) {
+	int errors = 0;
+
+	for (int y = 0; y < SSD1306_LCD_HEIGHT; y++) {
+		for (int x = 0; x < SSD1306_LCD_WIDTH; x++) {
+			int u = x - dx, v = y - dy;
+			int expected = (u >= 0 && v >= 0 && u < SSD1306_LCD_WIDTH &&
+				v < SSD1306_LCD_HEIGHT) ? Pbm[v][u] : 0;
+
+			errors += (host_pixel(x, y) != expected);
+		}
+	}
+
+	printf("  %-24s %5d pixels differ\n", name, errors);
+
+	return errors;
+}
+
+
+int main(int argc, char *argv[]) {
+	int errors = 0;
+
+	if (argc != 2 || readPbm(argv[1]) != 0) {
+		fprintf(stderr, "usage: %s image.pbm\n", argv[0]);
+		return 1;
+	}
+
+	if (SSD1306_init(&Hi2c) != LCD_OK) {
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+
+	printf("%dx%d image, %s\n", roundtrip.width, roundtrip.height,
+		roundtrip.compressed ? "RLE compressed" : "raw");
+
+	SSD1306_fill(SSD1306_COLOR_BLACK);
+	SSD1306_drawPackedImage(0, 0, &roundtrip, SSD1306_ROP_COPY);
+	SSD1306_updateScreen();
+	errors += compare("drawPackedImage (0, 0)", 0, 0);
+
+	// Not aligned to pages, and clipped on the right and bottom sides.
+	SSD1306_fill(SSD1306_COLOR_BLACK);
+	SSD1306_drawPackedImage(9, 5, &roundtrip, SSD1306_ROP_COPY);
+	SSD1306_updateScreen();
+	errors += compare("drawPackedImage (9, 5)", 9, 5);
+
+	SSD1306_fill(SSD1306_COLOR_BLACK);
+	SSD1306_updateScreen();
+	if (SSD1306_sendImage(&roundtrip) != LCD_OK) {
+		fprintf(stderr, "sendImage failed\n");
+		errors++;
+	}
+	errors += compare("sendImage", 0, 0);
+
+	return errors != 0;
+}
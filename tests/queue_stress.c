@@ -0,0 +1,261 @@
+/**
+ * @file   queue_stress.c
+ * @brief  Host stress test of the SSD1306 draw command queue: several
+ *         producer threads post commands while the main thread runs them.
+ *
+ * 		   Each producer posts pixel commands carrying its own sequence
+ * 		   number and text commands whose text encodes their position. The
+ * 		   driver drawing functions are replaced by checks: every producer
+ * 		   sequence must be run exactly once and in order, and every text
+ * 		   command must arrive intact.
+ *
+ * 		   Build and run from the repository root, optionally adding
+ * 		   -fsanitize=thread:
+ * 		   cc -O2 -std=c11 -pthread -Iinc -Itools/host tests/queue_stress.c
+ * 		      src/ssd1306_queue.c src/fonts.c -o queue_stress
+ * 		   ./queue_stress
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306_queue.h"
+
+
+// Commands posted by each producer. Half the sequence number is carried by
+// the Y coordinate, so it must stay below 65536.
+#define PRODUCERS 4
+#define COMMANDS  60000
+
+
+/**
+ * @brief Next sequence number expected from each producer.
+ */
+static long Expected[PRODUCERS];
+
+/**
+ * @brief Commands run and errors found.
+ */
+static long Run, Errors;
+
+/**
+ * @brief Position set by the last gotoXY, checked against the text.
+ */
+static int16_t TextX, TextY;
+
+
+/**
+ * @brief Checks that a command is the next one of its producer.
+ */
+static void checkSequence(int16_t producer, long seq) {
+	if (producer < 0 || producer >= PRODUCERS || seq != Expected[producer]) {
+		if (Errors++ < 10) {
+			fprintf(stderr, "producer %d: got %ld, expected %ld\n", producer,
+				seq, (producer >= 0 && producer < PRODUCERS) ?
+				Expected[producer] : -1);
+		}
+	} else {
+		Expected[producer]++;
+	}
+	Run++;
+}
+
+
+/**
+ * @brief Encodes the text of a command from its producer and sequence.
+ */
+static void makeText(char *text, int16_t producer, long seq) {
+	snprintf(text, SSD1306_QUEUE_TEXT_LEN, "p%d#%ld", producer, seq);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DRIVER REPLACEMENTS.
+///////////////////////////////////////////////////////////////////////////////
+
+SSD1306_status_t SSD1306_drawPixel(uint16_t x, uint16_t y,
+	SSD1306_color_t color) {
+
+	// The sequence number is split between Y and the color.
+	checkSequence(x, (long)y << 1 | color);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_gotoXY(uint16_t x, uint16_t y) {
+	TextX = x;
+	TextY = y;
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_puts(char *str, FontDef_t *font,
+	SSD1306_color_t color) {
+
+	char text[SSD1306_QUEUE_TEXT_LEN];
+	long seq = (long)TextY << 1 | color;
+
+	(void)font;
+
+	makeText(text, TextX, seq);
+	if (strcmp(text, str) != 0 && Errors++ < 10) {
+		fprintf(stderr, "torn text command: \"%s\", expected \"%s\"\n", str,
+			text);
+	}
+	checkSequence(TextX, seq);
+
+	return LCD_OK;
+}
+
+
+SSD1306_status_t SSD1306_fill(SSD1306_color_t color) {
+	(void)color;
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_drawLine(uint16_t x0, uint16_t y0, uint16_t x1,
+	uint16_t y1, SSD1306_color_t color) {
+
+	(void)x0; (void)y0; (void)x1; (void)y1; (void)color;
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_drawRoundRect(int16_t x, int16_t y, int16_t w,
+	int16_t h, int16_t r, SSD1306_color_t color) {
+
+	(void)x; (void)y; (void)w; (void)h; (void)r; (void)color;
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_drawFilledRoundRect(int16_t x, int16_t y, int16_t w,
+	int16_t h, int16_t r, SSD1306_color_t color) {
+
+	(void)x; (void)y; (void)w; (void)h; (void)r; (void)color;
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_drawCircle(int16_t x0, int16_t y0, int16_t r,
+	SSD1306_color_t color) {
+
+	(void)x0; (void)y0; (void)r; (void)color;
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_drawFilledCircle(int16_t x0, int16_t y0, int16_t r,
+	SSD1306_color_t color) {
+
+	(void)x0; (void)y0; (void)r; (void)color;
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_drawBitmap(int16_t x, int16_t y,
+	const uint8_t *bitmap, int16_t w, int16_t h, SSD1306_color_t color) {
+
+	(void)x; (void)y; (void)bitmap; (void)w; (void)h; (void)color;
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_updateArea(uint16_t x, uint16_t y, uint16_t w,
+	uint16_t h) {
+
+	(void)x; (void)y; (void)w; (void)h;
+	return INVALID_PARAMS;
+}
+
+
+SSD1306_status_t SSD1306_updateScreen(void) {
+	return INVALID_PARAMS;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TEST.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Producer: posts COMMANDS commands, retrying while the queue is full.
+ *        Pairs of commands alternate between pixels and text.
+ */
+static void *producer(void *arg) {
+	int16_t id = (int16_t)(long)arg;
+	SSD1306_cmd_t cmd;
+
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.x = id;
+
+	for (long seq = 0; seq < COMMANDS; seq++) {
+		cmd.type = (seq & 0x02) ? SSD1306_CMD_TEXT : SSD1306_CMD_PIXEL;
+		cmd.y = seq >> 1;
+		cmd.color = (SSD1306_color_t)(seq & 0x01);
+		makeText(cmd.text, id, seq);
+
+		while (SSD1306_queuePost(&cmd) == BUSY) {
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+
+int main(void) {
+	pthread_t threads[PRODUCERS];
+	long total = (long)PRODUCERS * COMMANDS, taken = 0;
+
+	SSD1306_queueInit();
+
+	for (long i = 0; i < PRODUCERS; i++) {
+		pthread_create(&threads[i], NULL, producer, (void *)i);
+	}
+
+	// Runs the commands in small batches, as a main loop would.
+	while (taken < total) {
+		uint16_t n;
+
+		if (SSD1306_queueProcess(7, &n) != LCD_OK && Errors++ < 10) {
+			fprintf(stderr, "a command failed\n");
+		}
+		if (n == 0) {
+			sched_yield();
+		}
+		taken += n;
+	}
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	if (Run != total) {
+		Errors++;
+	}
+
+	printf("%d producers, %ld commands run, %ld errors\n", PRODUCERS, Run,
+		Errors);
+
+	return Errors != 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file   bench_dither.c
+ * @brief  Host benchmark of SSD1306_drawGray: time per full-screen frame
+ *         with ordered (Bayer) and Floyd-Steinberg dithering, compared with
+ *         ordered dithering done by the application one SSD1306_drawPixel at
+ *         a time. The share of lit pixels is printed against the mean gray
+ *         level, as a check that the tone is kept.
+ *
+ * 		   Build and run from the repository root:
+ * 		   cc -O2 -std=c99 -Iinc -Itools/host tools/bench/bench_dither.c
+ * 		      tools/host/host_hal.c src/ssd1306.c src/fonts.c -o bench_dither
+ * 		   ./bench_dither
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <stdio.h>
+
+#include "host_hal.h"
+#include "ssd1306.h"
+
+
+#define FRAMES 2000
+
+
+/**
+ * @brief 8x8 Bayer matrix, the same order as the driver table.
+ */
+static const uint8_t Bayer[8][8] = {
+	{  0, 32,  8, 40,  2, 34, 10, 42 },
+	{ 48, 16, 56, 24, 50, 18, 58, 26 },
+	{ 12, 44,  4, 36, 14, 46,  6, 38 },
+	{ 60, 28, 52, 20, 62, 30, 54, 22 },
+	{  3, 35, 11, 43,  1, 33,  9, 41 },
+	{ 51, 19, 59, 27, 49, 17, 57, 25 },
+	{ 15, 47,  7, 39, 13, 45,  5, 37 },
+	{ 63, 31, 55, 23, 61, 29, 53, 21 }
+};
+
+
+static I2C_HandleTypeDef Hi2c;
+static uint8_t Gray[SSD1306_WIDTH * SSD1306_HEIGHT];
+
+
+/**
+ * @brief Ordered dithering by the application, one pixel at a time.
+ */
+static void drawPixels(void) {
+	for (int16_t y = 0; y < SSD1306_HEIGHT; y++) {
+		for (int16_t x = 0; x < SSD1306_WIDTH; x++) {
+			SSD1306_drawPixel(x, y, (SSD1306_color_t)
+				(Gray[y * SSD1306_WIDTH + x] > 4 * Bayer[y & 0x07][x & 0x07] + 2));
+		}
+	}
+}
+
+
+static void drawBayer(void) {
+	SSD1306_drawGray(0, 0, Gray, SSD1306_WIDTH, SSD1306_HEIGHT,
+		SSD1306_DITHER_BAYER);
+}
+
+
+static void drawFloydSteinberg(void) {
+	SSD1306_drawGray(0, 0, Gray, SSD1306_WIDTH, SSD1306_HEIGHT,
+		SSD1306_DITHER_FLOYD_STEINBERG);
+}
+
+
+/**
+ * @brief Times a frame drawing function and prints its cost and the share of
+ *        lit pixels it gives.
+ */
+static void measure(const char *name, void (*draw)(void)) {
+	double t0 = host_time_us(), t;
+	unsigned long lit = 0;
+
+	for (int i = 0; i < FRAMES; i++) {
+		draw();
+	}
+	t = (host_time_us() - t0) / FRAMES;
+
+	SSD1306_updateScreen();
+	for (int y = 0; y < SSD1306_HEIGHT; y++) {
+		for (int x = 0; x < SSD1306_WIDTH; x++) {
+			lit += host_pixel(x, y);
+		}
+	}
+
+	printf("%-26s %10.1f %9.2f%%\n", name, t,
+		100.0 * lit / (SSD1306_WIDTH * SSD1306_HEIGHT));
+}
+
+
+int main(void) {
+	unsigned long sum = 0;
+
+	if (SSD1306_init(&Hi2c) != LCD_OK) {
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+
+	// Horizontal ramp with a vertical ripple, so that every gray level and
+	// both directions of change are present.
+	for (int y = 0; y < SSD1306_HEIGHT; y++) {
+		for (int x = 0; x < SSD1306_WIDTH; x++) {
+			int g = x * 255 / (SSD1306_WIDTH - 1) + ((y & 0x0F) - 8) * 2;
+
+			g = (g < 0) ? 0 : (g > 255) ? 255 : g;
+			Gray[y * SSD1306_WIDTH + x] = g;
+			sum += g;
+		}
+	}
+
+	printf("%dx%d frame, mean gray %.2f%%, %d frames\n", SSD1306_WIDTH,
+		SSD1306_HEIGHT, 100.0 * sum / (255.0 * SSD1306_WIDTH * SSD1306_HEIGHT),
+		FRAMES);
+	printf("%-26s %10s %10s\n", "method", "us/frame", "lit");
+	measure("drawPixel, Bayer", drawPixels);
+	measure("drawGray, Bayer", drawBayer);
+	measure("drawGray, Floyd-Steinberg", drawFloydSteinberg);
+
+	return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file   bench_flush.c
+ * @brief  Host benchmark of the flush cost in each screen orientation: CPU
+ *         time spent by the driver and bytes sent on the i2c bus for a full
+ *         frame and for a small area.
+ *
+ * 		   The orientations are chosen at build time, so the benchmark is
+ * 		   built twice from the repository root, for 0 and 180 degrees and
+ * 		   for 90 and 270 degrees:
+ * 		   cc -O2 -std=c99 -Iinc -Itools/host tools/bench/bench_flush.c
+ * 		      tools/host/host_hal.c src/ssd1306.c src/fonts.c -o bench_flush
+ * 		   cc -O2 -std=c99 -DSSD1306_PORTRAIT=1 -Iinc -Itools/host
+ * 		      tools/bench/bench_flush.c tools/host/host_hal.c src/ssd1306.c
+ * 		      src/fonts.c -o bench_flush_portrait
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_hal.h"
+#include "ssd1306.h"
+
+
+#define FLUSHES 20000
+
+// i2c clock used to estimate the bus time: 9 bit times per byte.
+#define I2C_CLOCK_HZ 400000.0
+
+
+static I2C_HandleTypeDef Hi2c;
+
+
+/**
+ * @brief Times a flush function and prints its cost per call.
+ */
+static void measure(const char *name, SSD1306_status_t (*flush)(void)) {
+	unsigned long bytes = host_bytes_sent, transactions = host_transactions;
+	double t0 = host_time_us(), t;
+
+	for (int i = 0; i < FLUSHES; i++) {
+		flush();
+	}
+
+	t = (host_time_us() - t0) / FLUSHES;
+	bytes = (host_bytes_sent - bytes) / FLUSHES;
+	transactions = (host_transactions - transactions) / FLUSHES;
+
+	printf("  %-12s %10.2f %8lu %6lu %10.2f\n", name, t, bytes, transactions,
+		bytes * 9 / I2C_CLOCK_HZ * 1000);
+}
+
+
+/**
+ * @brief Full frame.
+ */
+static SSD1306_status_t flushScreen(void) {
+	return SSD1306_updateScreen();
+}
+
+
+/**
+ * @brief 32x16 pixels area, not aligned to pages.
+ */
+static SSD1306_status_t flushArea(void) {
+	return SSD1306_updateArea(20, 12, 32, 16);
+}
+
+
+int main(void) {
+#if SSD1306_PORTRAIT
+	SSD1306_rotation_t rotations[2] = { SSD1306_ROTATION_90,
+		SSD1306_ROTATION_270 };
+#else
+	SSD1306_rotation_t rotations[2] = { SSD1306_ROTATION_0,
+		SSD1306_ROTATION_180 };
+#endif
+
+	if (SSD1306_init(&Hi2c) != LCD_OK) {
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+
+	// Random content, so that no byte pattern is favoured.
+	srand(1);
+	for (int16_t y = 0; y < SSD1306_HEIGHT; y++) {
+		for (int16_t x = 0; x < SSD1306_WIDTH; x++) {
+			SSD1306_drawPixel(x, y, (SSD1306_color_t)(rand() & 0x01));
+		}
+	}
+
+	// Only the driver is timed: the LCD emulation is turned off.
+	host_emulate = 0;
+
+	printf("%dx%d drawing area, %d flushes per case\n", SSD1306_WIDTH,
+		SSD1306_HEIGHT, FLUSHES);
+	printf("  %-12s %10s %8s %6s %10s\n", "flush", "us (CPU)", "bytes",
+		"xfers", "ms at 400k");
+
+	for (int i = 0; i < 2; i++) {
+		SSD1306_setRotation(rotations[i]);
+		printf("rotation %d\n", rotations[i] * 90);
+		measure("full frame", flushScreen);
+		measure("32x16 area", flushArea);
+	}
+
+	return 0;
+}
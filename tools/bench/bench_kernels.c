@@ -0,0 +1,235 @@
+/**
+ * @file   bench_kernels.c
+ * @brief  Host benchmark of the buffer kernels: fill, rectangle inversion
+ *         and image composition done by the driver 32 bits at a time,
+ *         compared with the same work done one byte at a time and with
+ *         16-byte vectors.
+ *
+ * 		   The byte and vector loops work on a local page-format buffer.
+ * 		   The vector loops use the GCC/Clang vector extension, which maps
+ * 		   to SSE or NEON on hosts that have them. Cortex-M0/M3/M4 parts have
+ * 		   no such unit, so they only show what a SIMD path could bring on
+ * 		   a host build. Build and run from the repository root:
+ * 		   cc -O2 -std=gnu99 -Iinc -Itools/host tools/bench/bench_kernels.c
+ * 		      tools/host/host_hal.c src/ssd1306.c src/fonts.c -o bench_kernels
+ * 		   ./bench_kernels
+ * 		   Adding -fno-tree-vectorize keeps the compiler from vectorizing
+ * 		   the byte loops and the driver kernels by itself.
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "host_hal.h"
+#include "ssd1306.h"
+
+
+#define RUNS 200000
+
+// Inverted rectangle and composed image, not aligned to pages.
+#define RECT_X 10
+#define RECT_Y 3
+#define RECT_W 100
+#define RECT_H 40
+#define IMG_W  96
+#define IMG_H  32
+
+
+typedef uint8_t vec_t __attribute__((vector_size(16)));
+
+
+static I2C_HandleTypeDef Hi2c;
+static uint8_t Buffer[SSD1306_BUFFER_SIZE] __attribute__((aligned(16)));
+static uint8_t Image[IMG_W * IMG_H / 8];
+static volatile uint8_t Sink;
+
+
+/**
+ * @brief Returns the mask of the rows of page p between y0 and y1.
+ */
+static uint8_t pageMask(int p, int y0, int y1) {
+	uint8_t m = 0xFF;
+
+	if (y0 > p * 8) {
+		m &= 0xFF << (y0 - p * 8);
+	}
+	if (y1 < p * 8 + 7) {
+		m &= 0xFF >> (p * 8 + 7 - y1);
+	}
+
+	return m;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BYTE LOOPS.
+///////////////////////////////////////////////////////////////////////////////
+
+static void byteFill(uint8_t v) {
+	for (int i = 0; i < SSD1306_BUFFER_SIZE; i++) {
+		Buffer[i] = v;
+	}
+}
+
+
+static void byteInvert(void) {
+	for (int p = RECT_Y / 8; p <= (RECT_Y + RECT_H - 1) / 8; p++) {
+		uint8_t m = pageMask(p, RECT_Y, RECT_Y + RECT_H - 1);
+		uint8_t *d = &Buffer[p * SSD1306_WIDTH + RECT_X];
+
+		for (int x = 0; x < RECT_W; x++) {
+			d[x] ^= m;
+		}
+	}
+}
+
+
+/**
+ * @brief XOR of the image at Y = 8, so that pages line up.
+ */
+static void byteCompose(void) {
+	for (int p = 0; p < IMG_H / 8; p++) {
+		uint8_t *d = &Buffer[(p + 1) * SSD1306_WIDTH];
+		const uint8_t *s = &Image[p * IMG_W];
+
+		for (int x = 0; x < IMG_W; x++) {
+			d[x] ^= s[x];
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// VECTOR LOOPS.
+///////////////////////////////////////////////////////////////////////////////
+
+static void vecFill(uint8_t v) {
+	vec_t w;
+
+	memset(&w, v, sizeof(w));
+	for (int i = 0; i < SSD1306_BUFFER_SIZE; i += 16) {
+		*(vec_t *)&Buffer[i] = w;
+	}
+}
+
+
+static void vecInvert(void) {
+	for (int p = RECT_Y / 8; p <= (RECT_Y + RECT_H - 1) / 8; p++) {
+		uint8_t m = pageMask(p, RECT_Y, RECT_Y + RECT_H - 1);
+		uint8_t *d = &Buffer[p * SSD1306_WIDTH + RECT_X];
+		vec_t mw, dw;
+		int x = 0;
+
+		memset(&mw, m, sizeof(mw));
+		for (; x + 16 <= RECT_W; x += 16) {
+			memcpy(&dw, d + x, 16);
+			dw ^= mw;
+			memcpy(d + x, &dw, 16);
+		}
+		for (; x < RECT_W; x++) {
+			d[x] ^= m;
+		}
+	}
+}
+
+
+static void vecCompose(void) {
+	for (int p = 0; p < IMG_H / 8; p++) {
+		uint8_t *d = &Buffer[(p + 1) * SSD1306_WIDTH];
+		const uint8_t *s = &Image[p * IMG_W];
+		vec_t dw, sw;
+
+		for (int x = 0; x < IMG_W; x += 16) {
+			memcpy(&dw, d + x, 16);
+			memcpy(&sw, s + x, 16);
+			dw ^= sw;
+			memcpy(d + x, &dw, 16);
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DRIVER KERNELS.
+///////////////////////////////////////////////////////////////////////////////
+
+static void driverFill(uint8_t v) {
+	SSD1306_fill((SSD1306_color_t)(v & 0x01));
+}
+
+
+static void driverInvert(void) {
+	SSD1306_invertRect(RECT_X, RECT_Y, RECT_W, RECT_H);
+}
+
+
+static void driverCompose(void) {
+	SSD1306_drawImage(0, 8, Image, IMG_W, IMG_H, SSD1306_ROP_XOR);
+}
+
+
+/**
+ * @brief Times RUNS calls of fill, alternating black and white.
+ */
+static double timeFill(void (*fill)(uint8_t)) {
+	double t0 = host_time_us();
+
+	for (int i = 0; i < RUNS; i++) {
+		fill((i & 0x01) ? 0xFF : 0x00);
+	}
+	Sink ^= Buffer[7];
+
+	return (host_time_us() - t0) * 1000 / RUNS;
+}
+
+
+/**
+ * @brief Times RUNS calls of op.
+ */
+static double timeOp(void (*op)(void)) {
+	double t0 = host_time_us();
+
+	for (int i = 0; i < RUNS; i++) {
+		op();
+	}
+	Sink ^= Buffer[SSD1306_WIDTH + 20];
+
+	return (host_time_us() - t0) * 1000 / RUNS;
+}
+
+
+int main(void) {
+	if (SSD1306_init(&Hi2c) != LCD_OK) {
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+
+	for (unsigned int i = 0; i < sizeof(Image); i++) {
+		Image[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	printf("ns per call, %d calls\n", RUNS);
+	printf("%-30s %10s %10s %10s\n", "operation", "byte", "32-bit", "16-byte");
+	printf("%-30s %10.1f %10.1f %10.1f\n", "fill 128x64", timeFill(byteFill),
+		timeFill(driverFill), timeFill(vecFill));
+	printf("%-30s %10.1f %10.1f %10.1f\n", "invert 100x40 at y=3",
+		timeOp(byteInvert), timeOp(driverInvert), timeOp(vecInvert));
+	printf("%-30s %10.1f %10.1f %10.1f\n", "xor image 96x32 at y=8",
+		timeOp(byteCompose), timeOp(driverCompose), timeOp(vecCompose));
+
+	return 0;
+}
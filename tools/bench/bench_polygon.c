@@ -0,0 +1,233 @@
+/**
+ * @file   bench_polygon.c
+ * @brief  Host benchmark of SSD1306_drawFilledTriangle: pixels written
+ *         against pixels covered, compared with the former fill that drew a
+ *         line from every point of one edge to the third vertex.
+ *
+ * 		   The pixels written by the scanline fill are counted through the
+ * 		   span hook of the driver. Build and run from the repository root:
+ * 		   cc -O2 -std=c99 -DSSD1306_SPAN_HOOK=countSpan -Iinc -Itools/host
+ * 		      tools/bench/bench_polygon.c tools/host/host_hal.c src/ssd1306.c
+ * 		      src/fonts.c -o bench_polygon
+ * 		   ./bench_polygon
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_hal.h"
+#include "ssd1306.h"
+
+
+#ifndef SSD1306_SPAN_HOOK
+	#error Build with -DSSD1306_SPAN_HOOK=countSpan
+#endif
+
+
+#define TRIANGLES 2000
+#define ABS(x)    ((x) > 0 ? (x) : -(x))
+
+
+static I2C_HandleTypeDef Hi2c;
+static uint8_t Scanline[8][128];
+static unsigned long SpanPixels;
+
+
+/**
+ * @brief Span hook of the driver: counts the pixels the spans write.
+ */
+void countSpan(int16_t x0, int16_t x1, int16_t y) {
+	(void)y;
+	SpanPixels += x1 - x0 + 1;
+}
+
+
+/**
+ * @brief Bresenham line drawn pixel by pixel, as the former fill did.
+ *        Returns the number of pixels written.
+ */
+static unsigned long oldLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+	int16_t dx = ABS(x1 - x0), dy = ABS(y1 - y0);
+	int16_t sx = (x0 < x1) ? 1 : -1, sy = (y0 < y1) ? 1 : -1;
+	int16_t err = dx - dy, e2;
+	unsigned long written = 0;
+
+	while (1) {
+		SSD1306_drawPixel(x0, y0, SSD1306_COLOR_WHITE);
+		written++;
+		if (x0 == x1 && y0 == y1) {
+			break;
+		}
+		e2 = 2 * err;
+		if (e2 > -dy) {
+			err -= dy;
+			x0 += sx;
+		}
+		if (e2 < dx) {
+			err += dx;
+			y0 += sy;
+		}
+	}
+
+	return written;
+}
+
+
+/**
+ * @brief Former fill: walks the edge 1-2 and draws a line from each point to
+ *        vertex 3. Returns the number of pixels the lines write.
+ */
+static unsigned long oldFill(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+	int16_t x3, int16_t y3) {
+
+	int16_t dx = ABS(x2 - x1), dy = ABS(y2 - y1), x = x1, y = y1;
+	int16_t xinc1 = (x2 >= x1) ? 1 : -1, xinc2 = xinc1;
+	int16_t yinc1 = (y2 >= y1) ? 1 : -1, yinc2 = yinc1;
+	int16_t den, num, numadd, numpixels;
+	unsigned long written = 0;
+
+	if (dx >= dy) {
+		xinc1 = 0;
+		yinc2 = 0;
+		den = dx;
+		num = dx / 2;
+		numadd = dy;
+		numpixels = dx;
+	} else {
+		xinc2 = 0;
+		yinc1 = 0;
+		den = dy;
+		num = dy / 2;
+		numadd = dx;
+		numpixels = dy;
+	}
+
+	for (int16_t i = 0; i <= numpixels; i++) {
+		written += oldLine(x, y, x3, y3);
+
+		num += numadd;
+		if (num >= den) {
+			num -= den;
+			x += xinc1;
+			y += yinc1;
+		}
+		x += xinc2;
+		y += yinc2;
+	}
+
+	return written;
+}
+
+
+/**
+ * @brief Sends the buffer and counts the lit pixels of the emulated LCD.
+ */
+static unsigned long countLit(void) {
+	unsigned long lit = 0;
+
+	SSD1306_updateScreen();
+
+	for (int y = 0; y < SSD1306_HEIGHT; y++) {
+		for (int x = 0; x < SSD1306_WIDTH; x++) {
+			lit += host_pixel(x, y);
+		}
+	}
+
+	return lit;
+}
+
+
+int main(void) {
+	static int16_t v[TRIANGLES][6];
+	unsigned long covered_new = 0, covered_old = 0, written_old = 0;
+	unsigned long written_new = 0, gaps = 0;
+	double t0, t_new = 0, t_old = 0;
+
+	if (SSD1306_init(&Hi2c) != LCD_OK) {
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+
+	srand(1);
+	for (int i = 0; i < TRIANGLES; i++) {
+		for (int k = 0; k < 6; k += 2) {
+			v[i][k] = rand() % SSD1306_WIDTH;
+			v[i][k + 1] = rand() % SSD1306_HEIGHT;
+		}
+	}
+
+	// Pixels written and covered, one triangle at a time.
+	for (int i = 0; i < TRIANGLES; i++) {
+		unsigned long lit;
+
+		SSD1306_fill(SSD1306_COLOR_BLACK);
+		SpanPixels = 0;
+		SSD1306_drawFilledTriangle(v[i][0], v[i][1], v[i][2], v[i][3],
+			v[i][4], v[i][5], SSD1306_COLOR_WHITE);
+		written_new += SpanPixels;
+		lit = countLit();
+		covered_new += lit;
+		memcpy(Scanline, host_gddram, sizeof(Scanline));
+
+		SSD1306_fill(SSD1306_COLOR_BLACK);
+		written_old += oldFill(v[i][0], v[i][1], v[i][2], v[i][3], v[i][4],
+			v[i][5]);
+		covered_old += countLit();
+
+		// Pixels inside the triangle the lines never reached.
+		for (int p = 0; p < 8; p++) {
+			for (int x = 0; x < 128; x++) {
+				uint8_t miss = Scanline[p][x] & ~host_gddram[p][x];
+
+				for (; miss; miss &= miss - 1) {
+					gaps++;
+				}
+			}
+		}
+	}
+
+	// Drawing time only, without the flushes.
+	for (int rep = 0; rep < 10; rep++) {
+		t0 = host_time_us();
+		for (int i = 0; i < TRIANGLES; i++) {
+			SSD1306_drawFilledTriangle(v[i][0], v[i][1], v[i][2], v[i][3],
+				v[i][4], v[i][5], SSD1306_COLOR_WHITE);
+		}
+		t_new += host_time_us() - t0;
+
+		t0 = host_time_us();
+		for (int i = 0; i < TRIANGLES; i++) {
+			oldFill(v[i][0], v[i][1], v[i][2], v[i][3], v[i][4], v[i][5]);
+		}
+		t_old += host_time_us() - t0;
+	}
+
+	printf("%d random triangles on %dx%d\n", TRIANGLES, SSD1306_WIDTH,
+		SSD1306_HEIGHT);
+	printf("%-14s %12s %12s %10s %12s\n", "fill", "covered", "written",
+		"ratio", "us/triangle");
+	printf("%-14s %12lu %12lu %10.2f %12.2f\n", "edge-to-vertex", covered_old,
+		written_old, (double)written_old / covered_old,
+		t_old / (10.0 * TRIANGLES));
+	printf("%-14s %12lu %12lu %10.2f %12.2f\n", "scanline", covered_new,
+		written_new, (double)written_new / covered_new,
+		t_new / (10.0 * TRIANGLES));
+	printf("scanline pixels missed by edge-to-vertex: %lu\n", gaps);
+
+	return 0;
+}
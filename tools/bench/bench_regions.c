@@ -0,0 +1,152 @@
+/**
+ * @file   bench_regions.c
+ * @brief  Host benchmark of concurrent drawing with region locks: 1 to 8
+ *         threads share a fixed amount of drawing, each one inside its own
+ *         band of pages. It is compared with the same threads taking a
+ *         single mutex around every drawing call.
+ *
+ * 		   Build and run from the repository root:
+ * 		   cc -O2 -std=c11 -pthread -DSSD1306_REGION_LOCKS=1 -Iinc
+ * 		      -Itools/host tools/bench/bench_regions.c tools/host/host_hal.c
+ * 		      src/ssd1306.c src/fonts.c -o bench_regions
+ * 		   ./bench_regions
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "host_hal.h"
+#include "ssd1306.h"
+
+
+#if !SSD1306_REGION_LOCKS
+	#error Build with -DSSD1306_REGION_LOCKS=1
+#endif
+
+
+#define OPERATIONS  400000
+#define MAX_THREADS 8
+
+
+/**
+ * @brief Work of one thread.
+ */
+typedef struct {
+	pthread_t thread;
+	uint8_t   start_page;  /*!< First page of the band. */
+	uint8_t   end_page;    /*!< Last page of the band. */
+	uint8_t   use_mutex;   /*!< Takes the mutex instead of the band. */
+	long      operations;  /*!< Drawing operations to do. */
+} Worker_t;
+
+
+static I2C_HandleTypeDef Hi2c;
+static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * @brief Draws a few shapes inside one page of the band, locked either by
+ *        the region or by the mutex, for the given number of operations.
+ *        Every operation draws the same amount whatever the band size.
+ */
+static void *worker(void *arg) {
+	Worker_t *w = arg;
+	int16_t pages = w->end_page - w->start_page + 1;
+
+	for (long i = 0; i < w->operations; i++) {
+		int16_t x = (i * 7) % (SSD1306_WIDTH - 16);
+		int16_t top = (w->start_page + i % pages) * 8;
+		SSD1306_color_t color = (SSD1306_color_t)(i & 0x01);
+
+		if (w->use_mutex) {
+			pthread_mutex_lock(&Mutex);
+		} else {
+			SSD1306_lockRegion(w->start_page, w->end_page, 1);
+		}
+
+		SSD1306_drawFilledRectangle(x, top, 16, 7, color);
+		SSD1306_drawLine(0, top, SSD1306_WIDTH - 1, top + 7, !color);
+		SSD1306_drawFilledCircle(x + 8, top + 4, 3, !color);
+
+		if (w->use_mutex) {
+			pthread_mutex_unlock(&Mutex);
+		} else {
+			SSD1306_unlockRegion(w->start_page, w->end_page);
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Runs the operations split over the given number of threads, each
+ *        one owning SSD1306_MAX_PAGE_NUM / threads pages.
+ * @retval Elapsed time in microseconds.
+ */
+static double run(int threads, uint8_t use_mutex) {
+	Worker_t workers[MAX_THREADS];
+	uint8_t pages = SSD1306_MAX_PAGE_NUM / threads;
+	double t0 = host_time_us();
+
+	for (int i = 0; i < threads; i++) {
+		workers[i].start_page = i * pages;
+		workers[i].end_page = i * pages + pages - 1;
+		workers[i].use_mutex = use_mutex;
+		workers[i].operations = OPERATIONS / threads;
+		pthread_create(&workers[i].thread, NULL, worker, &workers[i]);
+	}
+
+	for (int i = 0; i < threads; i++) {
+		pthread_join(workers[i].thread, NULL);
+	}
+
+	return host_time_us() - t0;
+}
+
+
+int main(void) {
+	double base_regions = 0, base_mutex = 0;
+
+	if (SSD1306_init(&Hi2c) != LCD_OK) {
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+
+	printf("%d drawing operations, %ld CPUs online\n", OPERATIONS,
+		sysconf(_SC_NPROCESSORS_ONLN));
+	printf("%-8s %14s %9s %14s %9s\n", "threads", "regions ms", "speedup",
+		"mutex ms", "speedup");
+
+	for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		double t_regions = run(threads, 0);
+		double t_mutex = run(threads, 1);
+
+		if (threads == 1) {
+			base_regions = t_regions;
+			base_mutex = t_mutex;
+		}
+
+		printf("%-8d %14.1f %9.2f %14.1f %9.2f\n", threads, t_regions / 1000,
+			base_regions / t_regions, t_mutex / 1000, base_mutex / t_mutex);
+	}
+
+	return 0;
+}
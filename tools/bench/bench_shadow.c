@@ -0,0 +1,140 @@
+/**
+ * @file   bench_shadow.c
+ * @brief  Host benchmark of the shadow flush: bytes sent and bytes avoided
+ *         per flush, as counted by the driver, for a full redraw, a small
+ *         change and an unchanged frame.
+ *
+ * 		   Build and run from the repository root:
+ * 		   cc -O2 -std=c99 -DSSD1306_SHADOW_FLUSH=1 -Iinc -Itools/host
+ * 		      tools/bench/bench_shadow.c tools/host/host_hal.c src/ssd1306.c
+ * 		      src/fonts.c -o bench_shadow
+ * 		   ./bench_shadow
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_hal.h"
+#include "ssd1306.h"
+
+
+#if !SSD1306_SHADOW_FLUSH
+	#error Build with -DSSD1306_SHADOW_FLUSH=1
+#endif
+
+
+#define FLUSHES 2000
+
+
+static I2C_HandleTypeDef Hi2c;
+
+
+/**
+ * @brief Draws random pixels over the whole drawing area.
+ */
+static void randomFrame(void) {
+	for (int16_t y = 0; y < SSD1306_HEIGHT; y++) {
+		for (int16_t x = 0; x < SSD1306_WIDTH; x++) {
+			SSD1306_drawPixel(x, y, (SSD1306_color_t)(rand() & 0x01));
+		}
+	}
+}
+
+
+/**
+ * @brief Every byte changes: a new random frame.
+ */
+static void fullRedraw(int i) {
+	(void)i;
+	randomFrame();
+}
+
+
+/**
+ * @brief A 6x8 pixels counter digit changes, not aligned to pages.
+ */
+static void smallChange(int i) {
+	for (int16_t y = 20; y < 28; y++) {
+		for (int16_t x = 60; x < 66; x++) {
+			SSD1306_drawPixel(x, y, (SSD1306_color_t)(((x + y + i) & 0x01)));
+		}
+	}
+}
+
+
+/**
+ * @brief Nothing changes.
+ */
+static void unchanged(int i) {
+	(void)i;
+}
+
+
+/**
+ * @brief Draws and flushes a frame per iteration and prints the driver
+ *        counters per flush, with the bytes seen on the bus for reference.
+ */
+static void measure(const char *name, void (*draw)(int i)) {
+	SSD1306_flushStats_t stats;
+	unsigned long bytes = host_bytes_sent;
+	double t = 0;
+
+	SSD1306_resetFlushStats();
+
+	for (int i = 0; i < FLUSHES; i++) {
+		draw(i);
+
+		double t0 = host_time_us();
+		SSD1306_updateScreen();
+		t += host_time_us() - t0;
+	}
+
+	SSD1306_getFlushStats(&stats);
+	bytes = (host_bytes_sent - bytes) / FLUSHES;
+
+	printf("  %-14s %10lu %12lu %10lu %8lu %10.2f\n", name,
+		(unsigned long)stats.bytesSent, (unsigned long)stats.bytesAvoided,
+		(unsigned long)(stats.bytesSent / stats.flushes), bytes,
+		t / FLUSHES);
+}
+
+
+int main(void) {
+	if (SSD1306_init(&Hi2c) != LCD_OK) {
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+
+	// Starts from a frame the shadow already holds.
+	srand(1);
+	randomFrame();
+	SSD1306_updateScreen();
+
+	// Only the driver is timed: the LCD emulation is turned off.
+	host_emulate = 0;
+
+	printf("%dx%d drawing area, %d flushes per case\n", SSD1306_WIDTH,
+		SSD1306_HEIGHT, FLUSHES);
+	printf("  %-14s %10s %12s %10s %8s %10s\n", "case", "bytesSent",
+		"bytesAvoided", "per flush", "on bus", "us (CPU)");
+
+	measure("full redraw", fullRedraw);
+	measure("small change", smallChange);
+	measure("unchanged", unchanged);
+
+	return 0;
+}
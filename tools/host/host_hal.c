@@ -0,0 +1,194 @@
+/**
+ * @file   host_hal.c
+ * @brief  Host i2c and LCD simulation used by the SSD1306 host tools and
+ *         tests.
+ *
+ * 		   Each i2c transaction starts with the control byte: 0x00 for a
+ * 		   command stream, 0x40 for a data stream. Commands update the
+ * 		   addressing mode and the column and page pointers the same way as
+ * 		   the SSD1306 does, and data bytes are written into the emulated
+ * 		   internal RAM.
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <time.h>
+
+#include "host_hal.h"
+
+
+uint8_t host_gddram[8][128];
+unsigned long host_bytes_sent;
+unsigned long host_transactions;
+uint8_t host_emulate = 1;
+
+
+/**
+ * @brief Emulated LCD address state.
+ */
+static struct {
+	uint8_t mode;        /*!< 0 horizontal, 1 vertical, 2 page addressing. */
+	uint8_t col, col_start, col_end;
+	uint8_t page, page_start, page_end;
+	uint8_t cmd[8];      /*!< Command being received. */
+	uint8_t len, need;   /*!< Bytes received and expected. */
+} Lcd = { 2, 0, 0, 127, 0, 0, 7, { 0 }, 0, 0 };
+
+
+/**
+ * @brief Returns the number of argument bytes of a command.
+ */
+static uint8_t host_cmdArgs(uint8_t c) {
+	switch (c) {
+		case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5:
+		case 0xD6: case 0xD9: case 0xDA: case 0xDB: case 0x23:
+			return 1;
+		case 0x21: case 0x22: case 0xA3:
+			return 2;
+		case 0x29: case 0x2A:
+			return 5;
+		case 0x26: case 0x27:
+			return 6;
+		default:
+			return 0;
+	}
+}
+
+
+/**
+ * @brief Runs a complete command.
+ */
+static void host_runCmd(const uint8_t *p) {
+	if (p[0] == 0x20) {
+		Lcd.mode = p[1] & 0x03;
+	} else if (p[0] == 0x21) {
+		Lcd.col = Lcd.col_start = p[1] & 0x7F;
+		Lcd.col_end = p[2] & 0x7F;
+	} else if (p[0] == 0x22) {
+		Lcd.page = Lcd.page_start = p[1] & 0x07;
+		Lcd.page_end = p[2] & 0x07;
+	} else if (Lcd.mode == 2 && p[0] >= 0xB0 && p[0] <= 0xB7) {
+		Lcd.page = p[0] - 0xB0;
+	} else if (Lcd.mode == 2 && p[0] <= 0x0F) {
+		Lcd.col = (Lcd.col & 0xF0) | p[0];
+	} else if (Lcd.mode == 2 && p[0] >= 0x10 && p[0] <= 0x17) {
+		Lcd.col = (Lcd.col & 0x0F) | ((p[0] & 0x07) << 4);
+	}
+}
+
+
+/**
+ * @brief Receives a command byte.
+ */
+static void host_cmdByte(uint8_t b) {
+	if (Lcd.len == 0) {
+		Lcd.need = host_cmdArgs(b);
+	}
+
+	Lcd.cmd[Lcd.len++] = b;
+
+	if (Lcd.len == Lcd.need + 1) {
+		host_runCmd(Lcd.cmd);
+		Lcd.len = 0;
+	}
+}
+
+
+/**
+ * @brief Receives a data byte and moves the address pointer.
+ */
+static void host_dataByte(uint8_t b) {
+	host_gddram[Lcd.page][Lcd.col] = b;
+
+	if (Lcd.mode == 2) {
+		if (Lcd.col < 127) {
+			Lcd.col++;
+		}
+	} else if (Lcd.mode == 0) {
+		if (Lcd.col < Lcd.col_end) {
+			Lcd.col++;
+		} else {
+			Lcd.col = Lcd.col_start;
+			Lcd.page = (Lcd.page < Lcd.page_end) ? Lcd.page + 1 : Lcd.page_start;
+		}
+	} else {
+		if (Lcd.page < Lcd.page_end) {
+			Lcd.page++;
+		} else {
+			Lcd.page = Lcd.page_start;
+			Lcd.col = (Lcd.col < Lcd.col_end) ? Lcd.col + 1 : Lcd.col_start;
+		}
+	}
+}
+
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c,
+	uint16_t addr, uint32_t trials, uint32_t timeout) {
+
+	(void)hi2c;
+	(void)addr;
+	(void)trials;
+	(void)timeout;
+
+	return HAL_OK;
+}
+
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c,
+	uint16_t addr, uint8_t *data, uint16_t size, uint32_t timeout) {
+
+	(void)hi2c;
+	(void)addr;
+	(void)timeout;
+
+	host_transactions++;
+	host_bytes_sent += size + 1;
+
+	for (uint16_t i = 1; i < size && host_emulate; i++) {
+		if (data[0] & 0x40) {
+			host_dataByte(data[i]);
+		} else {
+			host_cmdByte(data[i]);
+		}
+	}
+
+	return HAL_OK;
+}
+
+
+void HAL_Delay(uint32_t ms) {
+	(void)ms;
+}
+
+
+uint32_t HAL_GetTick(void) {
+	return (uint32_t)(host_time_us() / 1000);
+}
+
+
+int host_pixel(int x, int y) {
+	return (host_gddram[y >> 3][x] >> (y & 0x07)) & 0x01;
+}
+
+
+double host_time_us(void) {
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file   host_hal.h
+ * @brief  Host i2c and LCD simulation used by the SSD1306 host tools and
+ *         tests. The LCD internal RAM is emulated from the commands and data
+ *         sent by the driver, and the bytes put on the bus are counted.
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#ifndef __HOST_HAL_H
+#define __HOST_HAL_H
+
+#include <stdint.h>
+
+#include "stm32f1xx_hal.h"
+
+
+/**
+ * @brief Emulated LCD internal RAM, page after page.
+ */
+extern uint8_t host_gddram[8][128];
+
+/**
+ * @brief Bytes sent on the i2c bus, address bytes included.
+ */
+extern unsigned long host_bytes_sent;
+
+/**
+ * @brief Number of i2c transactions.
+ */
+extern unsigned long host_transactions;
+
+/**
+ * @brief Set to 0 to only count the bytes sent, without updating the emulated
+ *        LCD, when timing the driver alone. It is 1 by default.
+ */
+extern uint8_t host_emulate;
+
+
+/**
+ * @brief  Returns the emulated LCD pixel at the given LCD RAM location.
+ */
+int host_pixel(int x, int y);
+
+
+/**
+ * @brief  Returns a monotonic time in microseconds.
+ */
+double host_time_us(void);
+
+#endif // __HOST_HAL_H
@@ -0,0 +1,50 @@
+/**
+ * @file   stm32f1xx_hal.h
+ * @brief  Host stand-in for the parts of the STM32 HAL used by the SSD1306
+ *         driver, so that host tools and tests can build the driver as is.
+ *         The i2c functions are implemented by host_hal.c.
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#ifndef __STM32F1XX_HAL_H
+#define __STM32F1XX_HAL_H
+
+#include <stdint.h>
+
+
+typedef enum {
+	HAL_OK = 0x00,
+	HAL_ERROR = 0x01,
+	HAL_BUSY = 0x02,
+	HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+typedef struct {
+	int unused;
+} I2C_HandleTypeDef;
+
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c,
+	uint16_t addr, uint32_t trials, uint32_t timeout);
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c,
+	uint16_t addr, uint8_t *data, uint16_t size, uint32_t timeout);
+
+void HAL_Delay(uint32_t ms);
+
+uint32_t HAL_GetTick(void);
+
+#endif // __STM32F1XX_HAL_H
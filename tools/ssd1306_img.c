@@ -0,0 +1,551 @@
+/**
+ * @file   ssd1306_img.c
+ * @brief  Host tool converting PBM and XBM images into page-format images
+ *         for the SSD1306 driver.
+ *
+ * 		   The image is written to the standard output as C source defining
+ * 		   an SSD1306_image_t, raw or RLE compressed, to be drawn with
+ * 		   SSD1306_drawPackedImage or sent with SSD1306_sendImage. A sequence
+ * 		   of images can be encoded instead as an SSD1306_animation_t made of
+ * 		   keyframes and delta frames, to be played by ssd1306_anim.c. Set
+ * 		   pixels (black in PBM files, foreground in XBM files) become lit
+ * 		   pixels.
+ *
+ *         <b>TOOL USAGE:</b>
+ *         <ol>
+ *         	 <li> Build it with any host C compiler:
+ *         	      cc -O2 -o ssd1306_img tools/ssd1306_img.c </li>
+ * 		     <li> Run it as: ssd1306_img [-c] [-i] [-n name] image.pbm
+ * 		          > image.c, where -c enables the compression, -i inverts
+ * 		          the pixels and -n sets the name of the image. </li>
+ * 		     <li> For an animation, run it as: ssd1306_img -a [-d ms]
+ * 		          [-k n] [-i] [-n name] frame1.pbm frame2.pbm ... > anim.c,
+ * 		          where -d sets the duration of each frame (100 ms by
+ * 		          default) and -k forces a keyframe every n frames. </li>
+ * 		   </ol>
+ *
+ * @copyright
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Giovanni Scotti
+ */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Bytes on the bus needed to start sending a span or a page. */
+#define RUN_SETUP 7
+
+/* Unchanged bytes between two changed spans of a page up to which the spans
+ * are merged: a new span costs 3 bytes of data and RUN_SETUP on the bus. */
+#define MERGE_GAP 5
+
+
+/**
+ * @brief Decoded 1bpp image, one byte per pixel.
+ */
+typedef struct {
+	int     width;
+	int     height;
+	uint8_t *pixels;
+} image_t;
+
+
+/**
+ * @brief Skips white space and comments of a PBM header.
+ */
+static void skip_space(FILE *f) {
+	int c;
+
+	while ((c = fgetc(f)) != EOF) {
+		if (c == '#') {
+			while ((c = fgetc(f)) != EOF && c != '\n');
+		} else if (!isspace(c)) {
+			ungetc(c, f);
+			return;
+		}
+	}
+}
+
+
+/**
+ * @brief Reads a plain (P1) or raw (P4) PBM image.
+ * @retval 0 on success, -1 on error.
+ */
+static int read_pbm(FILE *f, image_t *img) {
+	char magic[3] = { 0 };
+
+	if (fread(magic, 1, 2, f) != 2 || magic[0] != 'P' ||
+		(magic[1] != '1' && magic[1] != '4')) {
+
+		return -1;
+	}
+
+	skip_space(f);
+	if (fscanf(f, "%d", &img->width) != 1) return -1;
+	skip_space(f);
+	if (fscanf(f, "%d", &img->height) != 1) return -1;
+
+	if (img->width <= 0 || img->height <= 0) {
+		return -1;
+	}
+
+	img->pixels = calloc((size_t)img->width * img->height, 1);
+	if (img->pixels == NULL) {
+		return -1;
+	}
+
+	if (magic[1] == '1') {
+		for (int i = 0; i < img->width * img->height; i++) {
+			int c;
+
+			skip_space(f);
+			c = fgetc(f);
+			if (c != '0' && c != '1') {
+				return -1;
+			}
+			img->pixels[i] = (c == '1');
+		}
+	} else {
+		// A single white space character ends the header.
+		fgetc(f);
+
+		for (int y = 0; y < img->height; y++) {
+			for (int x = 0; x < img->width; x += 8) {
+				int c = fgetc(f);
+
+				if (c == EOF) {
+					return -1;
+				}
+
+				for (int b = 0; b < 8 && x + b < img->width; b++) {
+					img->pixels[y * img->width + x + b] = (c >> (7 - b)) & 1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief Reads an XBM image: the width and height defines followed by the
+ *        bytes of each row, least significant bit first.
+ * @retval 0 on success, -1 on error.
+ */
+static int read_xbm(FILE *f, image_t *img) {
+	char line[256];
+	int value;
+
+	img->width = img->height = 0;
+
+	while (fgets(line, sizeof(line), f) != NULL && strchr(line, '{') == NULL) {
+		char *p = strstr(line, "_width ");
+		char *q = strstr(line, "_height ");
+
+		if (p != NULL && sscanf(p + 7, "%d", &value) == 1) {
+			img->width = value;
+		} else if (q != NULL && sscanf(q + 8, "%d", &value) == 1) {
+			img->height = value;
+		}
+	}
+
+	if (img->width <= 0 || img->height <= 0) {
+		return -1;
+	}
+
+	img->pixels = calloc((size_t)img->width * img->height, 1);
+	if (img->pixels == NULL) {
+		return -1;
+	}
+
+	int stride = (img->width + 7) / 8;
+
+	for (int i = 0; i < stride * img->height; i++) {
+		int x = (i % stride) * 8;
+		int y = i / stride;
+
+		if (fscanf(f, " %i ,", &value) != 1) {
+			return -1;
+		}
+
+		for (int b = 0; b < 8 && x + b < img->width; b++) {
+			img->pixels[y * img->width + x + b] = (value >> b) & 1;
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief Converts the image into page format: page after page, one byte per
+ *        column, bit 0 on top.
+ */
+static uint8_t *to_pages(const image_t *img, int invert, size_t *size) {
+	int pages = (img->height + 7) / 8;
+	uint8_t *out = calloc((size_t)pages * img->width, 1);
+
+	if (out == NULL) {
+		return NULL;
+	}
+
+	for (int y = 0; y < img->height; y++) {
+		for (int x = 0; x < img->width; x++) {
+			if (img->pixels[y * img->width + x] ^ invert) {
+				out[(y / 8) * img->width + x] |= 1 << (y % 8);
+			}
+		}
+	}
+
+	*size = (size_t)pages * img->width;
+
+	return out;
+}
+
+
+/**
+ * @brief RLE compresses data in the format read by the driver: runs of 3 to
+ *        129 equal bytes become a control byte and the byte, anything else
+ *        is stored as literals, up to 128 per control byte.
+ * @retval Compressed size in bytes.
+ */
+static size_t compress(const uint8_t *src, size_t n, uint8_t *dst) {
+	size_t out = 0, i = 0;
+	long lit = -1;
+
+	while (i < n) {
+		size_t run = 1;
+
+		while (i + run < n && run < 129 && src[i + run] == src[i]) {
+			run++;
+		}
+
+		if (run >= 3) {
+			dst[out++] = (uint8_t)(run + 0x7E);
+			dst[out++] = src[i];
+			i += run;
+			lit = -1;
+			continue;
+		}
+
+		// Opens a literal run, or extends the current one.
+		if (lit < 0) {
+			lit = (long)out++;
+		}
+
+		dst[out++] = src[i++];
+		dst[lit] = (uint8_t)(out - lit - 2);
+
+		if (dst[lit] == 0x7F) {
+			lit = -1;
+		}
+	}
+
+	return out;
+}
+
+
+/**
+ * @brief Prints the image as C source.
+ */
+static void print_image(const char *name, const char *input, const image_t *img,
+	const uint8_t *data, size_t size, size_t raw, int compressed) {
+
+	printf("/* Generated by ssd1306_img from %s: %dx%d, %zu bytes", input,
+		img->width, img->height, raw);
+	if (compressed) {
+		printf(", %zu bytes compressed", size);
+	}
+	printf(". */\n\n#include \"ssd1306.h\"\n\n");
+
+	printf("static const uint8_t %s_data[%zu] = {", name, size);
+	for (size_t i = 0; i < size; i++) {
+		printf("%s0x%02X", (i % 12) ? ", " : (i ? ",\n\t" : "\n\t"), data[i]);
+	}
+	printf("\n};\n\n");
+
+	printf("const SSD1306_image_t %s = {\n\t%d, %d, %d, %s_data\n};\n", name,
+		img->width, img->height, compressed, name);
+}
+
+
+/**
+ * @brief Reads a PBM or XBM image, depending on the file extension.
+ * @retval 0 on success, -1 on error.
+ */
+static int load_image(const char *input, image_t *img) {
+	FILE *f = fopen(input, "rb");
+	int status;
+
+	if (f == NULL) {
+		perror(input);
+		return -1;
+	}
+
+	const char *ext = strrchr(input, '.');
+	if (ext != NULL && strcmp(ext, ".xbm") == 0) {
+		status = read_xbm(f, img);
+	} else {
+		status = read_pbm(f, img);
+	}
+	fclose(f);
+
+	if (status != 0) {
+		fprintf(stderr, "%s: not a valid PBM or XBM image\n", input);
+	}
+
+	return status;
+}
+
+
+/**
+ * @brief Encodes the changes from prev to cur as a delta frame body: spans
+ *        of page, column, length and new bytes, ended by 0xFF.
+ * @retval Size of the body in bytes.
+ */
+static size_t encode_delta(const uint8_t *prev, const uint8_t *cur, int width,
+	int pages, uint8_t *dst, int *spans) {
+
+	size_t out = 0;
+
+	*spans = 0;
+
+	for (int p = 0; p < pages; p++) {
+		const uint8_t *a = &prev[p * width];
+		const uint8_t *b = &cur[p * width];
+		int x = 0;
+
+		while (x < width) {
+			if (a[x] == b[x]) {
+				x++;
+				continue;
+			}
+
+			// Extends the span over short unchanged gaps.
+			int end = x + 1, last = x;
+
+			while (end < width && end - last <= MERGE_GAP && end - x < 255) {
+				if (a[end] != b[end]) {
+					last = end;
+				}
+				end++;
+			}
+
+			dst[out++] = (uint8_t)p;
+			dst[out++] = (uint8_t)x;
+			dst[out++] = (uint8_t)(last - x + 1);
+			memcpy(&dst[out], &b[x], last - x + 1);
+			out += last - x + 1;
+			x = last + 1;
+			(*spans)++;
+		}
+	}
+
+	dst[out++] = 0xFF;
+
+	return out;
+}
+
+
+/**
+ * @brief Encodes a sequence of images as an animation and prints it as C
+ *        source, with the compression ratio on the standard error.
+ * @retval 0 on success, -1 on error.
+ */
+static int encode_animation(const char *name, char **inputs, int count,
+	int invert, int duration, int key_interval) {
+
+	uint8_t *prev = NULL, *data = NULL;
+	size_t raw = 0, size = 0, n = 0;
+	int width = 0, height = 0, keyframes = 0;
+
+	for (int i = 0; i < count; i++) {
+		image_t img = { 0 };
+
+		if (load_image(inputs[i], &img) != 0) {
+			return -1;
+		}
+
+		if (i == 0) {
+			width = img.width;
+			height = img.height;
+
+			if (width > 255 || height > 254 * 8) {
+				fprintf(stderr, "%s: image too large\n", inputs[i]);
+				return -1;
+			}
+		} else if (img.width != width || img.height != height) {
+			fprintf(stderr, "%s: frame size differs from %s\n", inputs[i],
+				inputs[0]);
+			return -1;
+		}
+
+		uint8_t *cur = to_pages(&img, invert, &n);
+		int pages = (height + 7) / 8;
+
+		free(img.pixels);
+
+		// Worst cases: one control byte every 128 literals for the
+		// keyframe, one 3-byte header every changed byte for the delta.
+		uint8_t *key = malloc(n + n / 128 + 1);
+		uint8_t *delta = malloc(4 * n + 1);
+
+		data = realloc(data, size + 5 + 4 * n + 1);
+
+		if (cur == NULL || key == NULL || delta == NULL || data == NULL) {
+			fprintf(stderr, "out of memory\n");
+			return -1;
+		}
+
+		size_t key_size = compress(cur, n, key);
+		size_t delta_size = 0;
+		int spans = 0;
+		uint8_t *p = &data[size];
+		int forced = (prev == NULL) || (key_interval && i % key_interval == 0);
+
+		if (!forced) {
+			delta_size = encode_delta(prev, cur, width, pages, delta, &spans);
+		}
+
+		// Both frame types are weighed by their data plus the bytes sent on
+		// the bus: the whole area for a keyframe, the spans for a delta.
+		size_t key_cost = 2 + key_size + n + pages * RUN_SETUP;
+		size_t delta_cost = delta_size + delta_size - 3 * spans - 1 +
+			spans * RUN_SETUP;
+
+		p[1] = (uint8_t)duration;
+		p[2] = (uint8_t)(duration >> 8);
+
+		if (forced || key_cost <= delta_cost) {
+			p[0] = 0x00;
+			p[3] = (uint8_t)key_size;
+			p[4] = (uint8_t)(key_size >> 8);
+			memcpy(p + 5, key, key_size);
+			size += 5 + key_size;
+			keyframes++;
+		} else {
+			p[0] = 0x01;
+			memcpy(p + 3, delta, delta_size);
+			size += 3 + delta_size;
+		}
+
+		raw += n;
+		free(key);
+		free(delta);
+		free(prev);
+		prev = cur;
+	}
+
+	printf("/* Generated by ssd1306_img from %d frames: %dx%d, %zu bytes raw, "
+		"%zu bytes encoded. */\n\n#include \"ssd1306_anim.h\"\n\n", count,
+		width, height, raw, size);
+
+	printf("static const uint8_t %s_data[%zu] = {", name, size);
+	for (size_t i = 0; i < size; i++) {
+		printf("%s0x%02X", (i % 12) ? ", " : (i ? ",\n\t" : "\n\t"), data[i]);
+	}
+	printf("\n};\n\n");
+
+	printf("const SSD1306_animation_t %s = {\n\t%d, %d, %d, %s_data\n};\n",
+		name, width, height, count, name);
+
+	fprintf(stderr, "%d frames (%d keyframes) of %zu bytes: %zu -> %zu bytes "
+		"(%.1f%%, ratio %.2f:1)\n", count, keyframes, n, raw, size,
+		100.0 * size / raw, (double)raw / size);
+
+	free(prev);
+	free(data);
+
+	return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+	const char *name = "image";
+	char *inputs[256];
+	int count = 0, animation = 0;
+	int want_compression = 0, invert = 0, duration = 100, key_interval = 0;
+	image_t img = { 0 };
+	size_t raw, size;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-c") == 0) {
+			want_compression = 1;
+		} else if (strcmp(argv[i], "-i") == 0) {
+			invert = 1;
+		} else if (strcmp(argv[i], "-a") == 0) {
+			animation = 1;
+		} else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			name = argv[++i];
+		} else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+			duration = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+			key_interval = atoi(argv[++i]);
+		} else if (argv[i][0] != '-' && count < 256) {
+			inputs[count++] = argv[i];
+		} else {
+			count = 0;
+			break;
+		}
+	}
+
+	if (count == 0 || (!animation && count > 1) || duration < 0 ||
+		duration > 0xFFFF || key_interval < 0) {
+
+		fprintf(stderr, "usage: %s [-c] [-i] [-n name] image.pbm|image.xbm\n"
+			"       %s -a [-d ms] [-k n] [-i] [-n name] frame.pbm ...\n",
+			argv[0], argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (animation) {
+		return encode_animation(name, inputs, count, invert, duration,
+			key_interval) ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if (load_image(inputs[0], &img) != 0) {
+		return EXIT_FAILURE;
+	}
+
+	uint8_t *pages = to_pages(&img, invert, &raw);
+	// Worst case: one control byte every 128 literals.
+	uint8_t *packed = malloc(raw + raw / 128 + 1);
+
+	if (pages == NULL || packed == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return EXIT_FAILURE;
+	}
+
+	size = compress(pages, raw, packed);
+
+	// Compressed data is only kept if it is actually smaller.
+	if (want_compression && size < raw) {
+		print_image(name, inputs[0], &img, packed, size, raw, 1);
+		fprintf(stderr, "%s: %zu -> %zu bytes (%.1f%%)\n", inputs[0], raw,
+			size, 100.0 * size / raw);
+	} else {
+		print_image(name, inputs[0], &img, pages, raw, raw, 0);
+		fprintf(stderr, "%s: %zu bytes\n", inputs[0], raw);
+	}
+
+	free(packed);
+	free(pages);
+	free(img.pixels);
+
+	return EXIT_SUCCESS;
+}